@@ -113,6 +113,26 @@ void DFDetector::reportBug() {
         }
         // snk not reachable
         if (!evalNode) continue;
+        // states only flow from src, skip info map scans and solver calls for
+        // snks not graph-reachable from src (they can never be reachable or erroneous)
+        if (!isGraphReachableFromSrc(evalNode)) {
+            _stat->incGraphUnreachableSnkNum();
+            continue;
+        }
+        // errors are recorded at the error transition, consume the findings directly
+        if (PSAOptions::EagerError()) {
+            auto findingIt = _symStateMgr.getErrFindings().find(
+                    std::make_pair(node, getFSMParser()->getErrAbsState()));
+            if (findingIt != _symStateMgr.getErrFindings().end() &&
+                isSrcSnkReachable(srcReachableExeState, findingIt->second.getExecutionState())) {
+                reachableNodes.insert(node);
+                errNodes.insert(node);
+                errNodesToBranchCond[node] = findingIt->second.getBranchCondition();
+                errNodesToKeyNodes[node] = findingIt->second.getKeyNodesSet();
+            }
+            // the info map is only scanned for reachable (non-error) states when validating tests
+            if (!PSAOptions::ValidateTests()) continue;
+        }
         for (const auto &t: getOutTEdges(evalNode)) {
             for (const auto &absState: getFSMParser()->getAbsStates()) {
                 InfoKey tmpInfoKey = std::make_pair(
@@ -96,8 +96,10 @@ void MemLeakDetector::reportBug() {
     KeyNodesSet keyNodesSet;
     PSTA::SummaryKey uninitKey = std::make_pair(_mainFunc, getFSMParser()->getUninitAbsState());
     auto uninitIt = PSTA::_summaryMap.find(uninitKey);
-    if (uninitIt == PSTA::_summaryMap.end()) return;
-    absToSymState = SVFUtil::move(uninitIt->second);
+    if (uninitIt != PSTA::_summaryMap.end())
+        absToSymState = SVFUtil::move(uninitIt->second);
+    else if (!PSAOptions::EagerError())
+        return;
     for (const auto &s: absToSymState) {
         if (!getAbsTransitionHandler()->reachGlobal(_curEvalSVFGNode) &&
             s.first == getFSMParser()->getErrAbsState()) {
@@ -109,6 +111,20 @@ void MemLeakDetector::reportBug() {
             hasUninit = true;
         }
     }
+    // errors are recorded at the error transition (main's return), consume the findings directly
+    if (PSAOptions::EagerError() && !hasError && !getAbsTransitionHandler()->reachGlobal(_curEvalSVFGNode)) {
+        SymStates witnesses;
+        for (const auto &finding: _symStateMgr.getErrFindings())
+            witnesses.push_back(finding.second);
+        if (!witnesses.empty()) {
+            // report the join of the witnesses of all error nodes, as for the summary of main
+            SymState joined;
+            groupingAbsStates(witnesses, joined);
+            hasError = true;
+            brc = joined.getBranchCondition();
+            keyNodesSet = SVFUtil::move(joined.getKeyNodesSet());
+        }
+    }
     LEAK_TYPE leakType = SAFE;
     // src not reach return, maybe dead loop
     if (!hasError && !hasUninit) {
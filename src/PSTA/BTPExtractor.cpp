@@ -51,7 +51,7 @@ BTPExtractor::detailBugReport(const Z3Expr &branchCond, const KeyNodesSet &keyNo
     u32_t ct = 0;
     for (const auto &keyNodes: keyNodesSet) {
         // Produce bug report and bug-triggering paths
-        Set<u32_t> temporalSlice, spatialSlice, callSites;
+        DenseNodeSet temporalSlice, spatialSlice, callSites;
         ICFGWrapperBuilder builder;
         builder.build(icfg);
         removeFSMNodeBody(curEvalICFGNode, curEvalFuns);
@@ -213,7 +213,7 @@ void BTPExtractor::extractBTPs(const ICFGNode *curEvalICFGNode, Set<const SVFFun
 void
 BTPExtractor::temporalSlicing(const SVFGNode *curEvalSVFGNode, const KeyNodes &keyNodes,
                               const ICFGNodeWrapper *mainEntry,
-                              Set<u32_t> &temporalSlice, Set<const SVFFunction *> &curEvalFuns) {
+                              DenseNodeSet &temporalSlice, Set<const SVFFunction *> &curEvalFuns) {
     clearDF();
     std::vector<PIState::DataFact> allDataFacts;
     KeyNodes dataFactTmp;
@@ -263,8 +263,8 @@ BTPExtractor::temporalSlicing(const SVFGNode *curEvalSVFGNode, const KeyNodes &k
  * @param callsites
  */
 void
-BTPExtractor::spatialSlicing(const SVFGNode *src, const KeyNodes &keyNodes, Set<u32_t> &temporalSlice,
-                             Set<u32_t> &spatialSlice, Set<u32_t> &callsites) {
+BTPExtractor::spatialSlicing(const SVFGNode *src, const KeyNodes &keyNodes, DenseNodeSet &temporalSlice,
+                             DenseNodeSet &spatialSlice, DenseNodeSet &callsites) {
     ControlDGBuilder cdBuilder;
     cdBuilder.build();
     ControlDG *controlDG = ControlDG::getControlDG();
@@ -277,7 +277,7 @@ BTPExtractor::spatialSlicing(const SVFGNode *src, const KeyNodes &keyNodes, Set<
     Set<CxtDPItem> callGDPItems;
 
     Set<CxtDPItem> workListLayer;
-    Set<u32_t> visited;
+    DenseNodeSet visited;
     getICFGWrapper()->annotateTemporalSlice(temporalSlice);
     ContextCond cxt;
     for (const auto &id: keyNodes) {
@@ -303,7 +303,7 @@ BTPExtractor::spatialSlicing(const SVFGNode *src, const KeyNodes &keyNodes, Set<
                 for (const auto &e: cdNode->getInEdges()) {
                     if (getICFGWrapper()->getICFGNodeWrapper(e->getSrcID())->_inTSlice) {
                         CxtDPItem item(e->getSrcID(), curNode.getContexts());
-                        if (visited.find(item.getCurNodeID()) == visited.end()) {
+                        if (!visited.count(item.getCurNodeID())) {
                             visited.insert(item.getCurNodeID());
                             nxtWorkListLayer.insert(SVFUtil::move(item));
                             spatialSlice.insert(e->getSrcID());
@@ -315,7 +315,7 @@ BTPExtractor::spatialSlicing(const SVFGNode *src, const KeyNodes &keyNodes, Set<
             const ICFGNodeWrapper *icfgNodeWrapper = getICFGWrapper()->getICFGNodeWrapper(curNodeID);
             if (const RetICFGNode *retICFGNode = dyn_cast<RetICFGNode>(icfgNodeWrapper->getICFGNode())) {
                 if (icfgNodeWrapper->_inTSlice) {
-                    if (spatialSlice.find(retICFGNode->getCallICFGNode()->getId()) == spatialSlice.end()) {
+                    if (!spatialSlice.count(retICFGNode->getCallICFGNode()->getId())) {
                         spatialSlice.insert(retICFGNode->getCallICFGNode()->getId());
                     }
                 }
@@ -330,7 +330,7 @@ BTPExtractor::spatialSlicing(const SVFGNode *src, const KeyNodes &keyNodes, Set<
                                 pag->getGNode(pag->getValueNode(cs.getArgOperand(i))));
                         NodeID nodeId = vfNode->getICFGNode()->getId();
                         CxtDPItem item(nodeId, curNode.getContexts());
-                        if (visited.find(item.getCurNodeID()) == visited.end()) {
+                        if (!visited.count(item.getCurNodeID())) {
                             visited.insert(item.getCurNodeID());
                             spatialSlice.insert(nodeId);
                             nxtWorkListLayer.insert(SVFUtil::move(item));
@@ -348,7 +348,7 @@ BTPExtractor::spatialSlicing(const SVFGNode *src, const KeyNodes &keyNodes, Set<
                     NodeID nodeId = vfNode->getICFGNode()->getId();
                     if (getICFGWrapper()->getICFGNodeWrapper(nodeId)->_inTSlice) {
                         CxtDPItem item(nodeId, curNode.getContexts());
-                        if (visited.find(item.getCurNodeID()) == visited.end()) {
+                        if (!visited.count(item.getCurNodeID())) {
                             spatialSlice.insert(nodeId);
                             visited.insert(nodeId);
                             nxtWorkListLayer.insert(SVFUtil::move(item));
@@ -367,7 +367,7 @@ BTPExtractor::spatialSlicing(const SVFGNode *src, const KeyNodes &keyNodes, Set<
                             NodeID nodeId = vfNode->getICFGNode()->getId();
                             if (getICFGWrapper()->getICFGNodeWrapper(nodeId)->_inTSlice) {
                                 CxtDPItem item(nodeId, curNode.getContexts());
-                                if (visited.find(item.getCurNodeID()) == visited.end()) {
+                                if (!visited.count(item.getCurNodeID())) {
                                     spatialSlice.insert(nodeId);
                                     visited.insert(nodeId);
                                     nxtWorkListLayer.insert(SVFUtil::move(item));
@@ -605,6 +605,8 @@ void BranchAllocator::setBranchCond(const ICFGEdge *edge, Condition &cond) {
     //assert(condPosMap.find(pos) == condPosMap.end() && "this branch has already been set ");
 
     condPosMap[pos] = cond;
+    // branch conditions stay alive with icfgNodeConds, their sizes are cached for good
+    _branchCondSizes[cond.id()] = getExprSize(cond);
     auto it = _condIdToTermInstMap.find(cond.id());
     if (it != _condIdToTermInstMap.end()) {
         const ICFGNode *pNode = edge->getDstNode();
@@ -692,17 +694,238 @@ Z3Expr BranchAllocator::condOrLimit(const Z3Expr &lhs, const Z3Expr &rhs) {
 
 /*!
  * Size of the expression
+ *
+ * Same as the tree size, but computed over the DAG in post-order:
+ * each shared subterm is visited once and its size is memoized by AST id
  * @param z3Expr
  * @return
  */
 u32_t BranchAllocator::getExprSize(const Z3Expr &z3Expr) {
-    u32_t res = 1;
-    if (z3Expr.getExpr().num_args() == 0) {
-        return 1;
+    BranchAllocator *condAllocator = getCondAllocator();
+    if (const u32_t *size = condAllocator->getCachedExprSize(z3Expr.id()))
+        return *size;
+    // sizes computed in this call, kept here since the shared memo may be cleared when full
+    Map<u32_t, ExprSize> sizes;
+    auto lookup = [&](u32_t id) -> const u32_t * {
+        auto it = sizes.find(id);
+        if (it != sizes.end()) return &it->second.second;
+        return condAllocator->getCachedExprSize(id);
+    };
+    // the flag marks whether the args of the expression have been pushed
+    std::vector<std::pair<z3::expr, bool>> workList;
+    workList.emplace_back(z3Expr.getExpr(), false);
+    while (!workList.empty()) {
+        const z3::expr cur = workList.back().first;
+        if (lookup(cur.id())) {
+            workList.pop_back();
+            continue;
+        }
+        if (!workList.back().second) {
+            workList.back().second = true;
+            for (u32_t i = 0; i < cur.num_args(); ++i) {
+                const z3::expr &arg = cur.arg(i);
+                if (!lookup(arg.id()))
+                    workList.emplace_back(arg, false);
+            }
+        } else {
+            workList.pop_back();
+            u64_t size = 1;
+            for (u32_t i = 0; i < cur.num_args(); ++i)
+                size += *lookup(cur.arg(i).id());
+            sizes.emplace(cur.id(), std::make_pair(Z3Expr(cur), (u32_t) std::min<u64_t>(size, UINT32_MAX)));
+        }
+    }
+    u32_t res = *lookup(z3Expr.id());
+    for (const auto &item: sizes)
+        condAllocator->cacheExprSize(item.second.first, item.second.second);
+    return res;
+}
+
+/*!
+ * Whether the size of the expression is greater than limit
+ *
+ * Accumulate the tree size in pre-order and stop as soon as the limit is crossed,
+ * memoized subterms (e.g., branch conditions) are not walked
+ * @param z3Expr
+ * @param limit
+ * @return
+ */
+bool BranchAllocator::exceedsExprSize(const Z3Expr &z3Expr, u32_t limit) {
+    BranchAllocator *condAllocator = getCondAllocator();
+    u64_t size = 0;
+    std::vector<z3::expr> workList;
+    workList.push_back(z3Expr.getExpr());
+    while (!workList.empty()) {
+        const z3::expr cur = workList.back();
+        workList.pop_back();
+        if (const u32_t *cachedSize = condAllocator->getCachedExprSize(cur.id())) {
+            size += *cachedSize;
+        } else {
+            size += 1;
+            for (u32_t i = 0; i < cur.num_args(); ++i)
+                workList.push_back(cur.arg(i));
+        }
+        if (size > limit) return true;
+    }
+    // the walk is complete, size is exact
+    condAllocator->cacheExprSize(z3Expr, size);
+    return false;
+}
+
+const u32_t *BranchAllocator::getCachedExprSize(u32_t id) const {
+    auto it = _branchCondSizes.find(id);
+    if (it != _branchCondSizes.end()) return &it->second;
+    auto it2 = _exprSizes.find(id);
+    if (it2 != _exprSizes.end()) return &it2->second.second;
+    return nullptr;
+}
+
+void BranchAllocator::cacheExprSize(const Z3Expr &z3Expr, u32_t size) {
+    if (PSAOptions::MaxExprSizeCache() != 0 && _exprSizes.size() >= PSAOptions::MaxExprSizeCache())
+        _exprSizes.clear();
+    _exprSizes.emplace(z3Expr.id(), std::make_pair(z3Expr, size));
+}
+
+/*!
+ * Translate a condition into its BDD
+ *
+ * and/or/not are expanded, every other atom (e.g., a comparison over program data)
+ * becomes a BDD variable of its own so that the BDD over-approximates satisfiability
+ * @param cond
+ * @return
+ */
+BranchAllocator::BDDNode BranchAllocator::toBDD(const Condition &cond) {
+    auto it = _condIdToBDD.find(cond.id());
+    if (it != _condIdToBDD.end()) return it->second.second;
+    const z3::expr &expr = cond.getExpr();
+    BDDNode res;
+    if (expr.is_true()) {
+        res = PathCondBDD::TrueNode;
+    } else if (expr.is_false()) {
+        res = PathCondBDD::FalseNode;
+    } else if (expr.num_args() == 0) {
+        auto varIt = _condIdToBDDVar.find(cond.id());
+        if (varIt != _condIdToBDDVar.end()) {
+            res = _bdd.getVar(varIt->second);
+        } else {
+            // a boolean constant that is not a branch condition is still propositional
+            auto atomIt = _atomIdToBDDVar.find(cond.id());
+            if (atomIt == _atomIdToBDDVar.end())
+                atomIt = _atomIdToBDDVar.emplace(cond.id(), newBDDVar(cond, false)).first;
+            res = _bdd.getVar(atomIt->second);
+        }
+    } else {
+        Z3_decl_kind kind = expr.decl().decl_kind();
+        if (kind == Z3_OP_NOT) {
+            res = _bdd.bddNeg(toBDD(expr.arg(0)));
+        } else if (kind == Z3_OP_AND) {
+            res = PathCondBDD::TrueNode;
+            for (u32_t i = 0; i < expr.num_args(); ++i)
+                res = _bdd.bddAnd(res, toBDD(expr.arg(i)));
+        } else if (kind == Z3_OP_OR) {
+            res = PathCondBDD::FalseNode;
+            for (u32_t i = 0; i < expr.num_args(); ++i)
+                res = _bdd.bddOr(res, toBDD(expr.arg(i)));
+        } else {
+            auto atomIt = _atomIdToBDDVar.find(cond.id());
+            if (atomIt == _atomIdToBDDVar.end())
+                atomIt = _atomIdToBDDVar.emplace(cond.id(), newBDDVar(cond, true)).first;
+            res = _bdd.getVar(atomIt->second);
+        }
     }
-    for (u32_t i = 0; i < z3Expr.getExpr().num_args(); ++i) {
-        Z3Expr expr = z3Expr.getExpr().arg(i);
-        res += getExprSize(expr);
+    _condIdToBDD[cond.id()] = std::make_pair(cond, res);
+    return res;
+}
+
+/*!
+ * Translate a BDD back into a branch condition
+ *
+ * The result is canonical: equivalent conditions share one Z3 AST,
+ * and literals reuse the atom conditions so that exactCondElem still works
+ * @param node
+ * @return
+ */
+BranchAllocator::Condition BranchAllocator::fromBDD(BDDNode node) {
+    if (node == PathCondBDD::TrueNode) return getTrueCond();
+    if (node == PathCondBDD::FalseNode) return getFalseCond();
+    auto it = _bddToCond.find(node);
+    if (it != _bddToCond.end()) return it->second;
+    const Condition &var = _bddVarToCond[_bdd.getNodeVar(node)];
+    BDDNode lo = _bdd.getLo(node), hi = _bdd.getHi(node);
+    Condition res;
+    if (hi == PathCondBDD::TrueNode && lo == PathCondBDD::FalseNode) {
+        res = var;
+    } else if (hi == PathCondBDD::FalseNode && lo == PathCondBDD::TrueNode) {
+        res = condNeg(var);
+    } else if (hi == PathCondBDD::FalseNode) {
+        res = condNeg(var) && fromBDD(lo);
+    } else if (lo == PathCondBDD::FalseNode) {
+        res = var && fromBDD(hi);
+    } else if (hi == PathCondBDD::TrueNode) {
+        res = var || fromBDD(lo);
+    } else if (lo == PathCondBDD::TrueNode) {
+        res = condNeg(var) || fromBDD(hi);
+    } else {
+        res = (var && fromBDD(hi)) || (condNeg(var) && fromBDD(lo));
     }
+    _bddToCond[node] = res;
+    _condIdToBDD[res.id()] = std::make_pair(res, node);
+    return res;
+}
+
+bool BranchAllocator::bddHasTheory(BDDNode node) {
+    if (node == PathCondBDD::TrueNode || node == PathCondBDD::FalseNode) return false;
+    auto it = _bddHasTheory.find(node);
+    if (it != _bddHasTheory.end()) return it->second;
+    bool res = _bddVarIsTheory[_bdd.getNodeVar(node)] || bddHasTheory(_bdd.getLo(node)) ||
+               bddHasTheory(_bdd.getHi(node));
+    _bddHasTheory[node] = res;
     return res;
-}
\ No newline at end of file
+}
+
+/*!
+ * Decide satisfiability on the BDD
+ *
+ * The false terminal is unsat, theory atoms included.
+ * Any other BDD is sat unless it only holds through theory atoms,
+ * which the caller hands over to Z3
+ * @param cond
+ * @return
+ */
+z3::check_result BranchAllocator::bddCheck(const Condition &cond) {
+    boundBDDMemo();
+    BDDNode node = toBDD(cond);
+    if (node == PathCondBDD::FalseNode) {
+        ++_bddDecidedNum;
+        return z3::unsat;
+    }
+    if (!bddHasTheory(node)) {
+        ++_bddDecidedNum;
+        return z3::sat;
+    }
+    return z3::unknown;
+}
+
+/*!
+ * Rebuild an empty BDD over the branch condition variables
+ *
+ * Other atoms and all memoized translations are dropped, they are
+ * re-created on demand. Z3 hash-conses ASTs, so canonical forms keep their ids
+ */
+void BranchAllocator::resetBDD() {
+    std::vector<Condition> branchConds;
+    for (const Condition &cond: _bddVarToCond)
+        if (_condIdToBDDVar.count(cond.id()))
+            branchConds.push_back(cond);
+    _bdd = PathCondBDD();
+    _condIdToBDDVar.clear();
+    _atomIdToBDDVar.clear();
+    _bddVarToCond.clear();
+    _bddVarIsTheory.clear();
+    _condIdToBDD.clear();
+    _bddToCond.clear();
+    _bddHasTheory.clear();
+    for (const Condition &cond: branchConds)
+        _condIdToBDDVar[cond.id()] = newBDDVar(cond, false);
+    ++_bddResetNum;
+}
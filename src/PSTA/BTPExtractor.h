@@ -8,6 +8,7 @@
 #include "Slicing/GraphSparsificator.h"
 #include "Util/Z3Expr.h"
 #include "AE/Core/SymState.h"
+#include "PSTA/PathCondBDD.h"
 
 namespace SVF {
 
@@ -34,6 +35,31 @@ private:
 public:
 
     typedef Z3Expr Condition;
+    typedef PathCondBDD::BDDNode BDDNode;
+
+private:
+    /// BDD backend of branch conditions (-bdd-path-cond)
+    //{%
+    PathCondBDD _bdd;
+    Map<u32_t, u32_t> _condIdToBDDVar;       ///< branch condition id -> BDD variable
+    Map<u32_t, u32_t> _atomIdToBDDVar;       ///< other atom (e.g., a data comparison) id -> BDD variable
+    std::vector<Condition> _bddVarToCond;    ///< BDD variable -> atom condition
+    std::vector<bool> _bddVarIsTheory;       ///< whether the BDD variable stands for a theory atom
+    Map<u32_t, std::pair<Condition, BDDNode>> _condIdToBDD; ///< memoized Z3 -> BDD translation, the condition pins the AST id
+    Map<BDDNode, Condition> _bddToCond;      ///< memoized BDD -> Z3 translation (canonical form)
+    Map<BDDNode, bool> _bddHasTheory;        ///< memoized theory atom occurrence of a BDD
+    u32_t _bddResetNum{0};                   ///< number of times the BDD backend is reset to bound the memos
+    u32_t _bddDecidedNum{0};                 ///< number of feasibility checks decided without Z3
+    //%}
+
+    /// Expression sizing
+    //{%
+    typedef std::pair<Z3Expr, u32_t> ExprSize;
+    Map<u32_t, u32_t> _branchCondSizes;      ///< AST id of each branch condition -> its size
+    Map<u32_t, ExprSize> _exprSizes;         ///< AST id -> (expr, size), the expr pins the id
+    //%}
+
+public:
 
     typedef Map<s64_t, Condition> CondPosMap;        ///< map a branch to its Condition
     typedef Map<const ICFGNode *, CondPosMap> ICFGNodeCondMap; ///< map ICFG node to a Condition
@@ -53,6 +79,12 @@ public:
     /// Destructor
     virtual ~BranchAllocator() {
         icfgNodeConds.clear();
+        _branchCondSizes.clear();
+        _exprSizes.clear();
+        _condIdToBDD.clear();
+        _bddToCond.clear();
+        _bddHasTheory.clear();
+        _bddVarToCond.clear();
         atomConditions.clear();
     }
 
@@ -76,13 +108,27 @@ public:
         return res;
     }
 
+    /// Satisfiability of a path condition, decided on the BDD when -bdd-path-cond is on
+    /// and Z3 is only called when the BDD is satisfiable through theory atoms
+    static inline z3::check_result condCheck(const Z3Expr &e) {
+        if (PSAOptions::BDDPathCond()) {
+            z3::check_result res = getCondAllocator()->bddCheck(e);
+            if (res != z3::unknown) return res;
+        }
+        return solverCheck(e);
+    }
+
     /// Condition operations
     //@{
     static inline Condition condAnd(const Condition &lhs, const Condition &rhs) {
+        if (PSAOptions::BDDPathCond())
+            return getCondAllocator()->bddCondAnd(lhs, rhs);
         return (lhs && rhs).simplify();
     }
 
     static inline Condition condOr(const Condition &lhs, const Condition &rhs) {
+        if (PSAOptions::BDDPathCond())
+            return getCondAllocator()->bddCondOr(lhs, rhs);
         return (lhs || rhs).simplify();
     }
 
@@ -94,9 +140,60 @@ public:
 
     static Z3Expr condOrLimit(const Z3Expr &lhs, const Z3Expr &rhs);
 
-    /// Size of the expression
+    /// Size of the expression (tree size, each shared subterm is visited once)
     static u32_t getExprSize(const Z3Expr &lhs);
 
+    /// Whether the size of the expression is greater than limit, stop as soon as the limit is crossed
+    static bool exceedsExprSize(const Z3Expr &z3Expr, u32_t limit);
+
+    /// BDD backend
+    //{%
+    /// Translate a branch condition into its BDD
+    BDDNode toBDD(const Condition &cond);
+
+    /// Translate a BDD back into a canonical branch condition
+    Condition fromBDD(BDDNode node);
+
+    /// Whether the BDD depends on a theory atom
+    bool bddHasTheory(BDDNode node);
+
+    /// Propositional satisfiability on the BDD (unknown if it only holds through theory atoms)
+    z3::check_result bddCheck(const Condition &cond);
+
+    /// Drop all BDD nodes and memos, keeping the branch condition variables
+    void resetBDD();
+
+    inline Condition bddCondAnd(const Condition &lhs, const Condition &rhs) {
+        boundBDDMemo();
+        return fromBDD(_bdd.bddAnd(toBDD(lhs), toBDD(rhs)));
+    }
+
+    inline Condition bddCondOr(const Condition &lhs, const Condition &rhs) {
+        boundBDDMemo();
+        return fromBDD(_bdd.bddOr(toBDD(lhs), toBDD(rhs)));
+    }
+
+    /// Reset the backend once the translation memos reach -max-simplify-cache,
+    /// only called before a top-level operation so that no BDD node is live
+    inline void boundBDDMemo() {
+        if (PSAOptions::MaxSimplifyCache() != 0 &&
+            _condIdToBDD.size() + _bddToCond.size() >= PSAOptions::MaxSimplifyCache())
+            resetBDD();
+    }
+
+    inline const PathCondBDD &getPathCondBDD() const {
+        return _bdd;
+    }
+
+    inline u32_t getBDDResetNum() const {
+        return _bddResetNum;
+    }
+
+    inline u32_t getBDDDecidedNum() const {
+        return _bddDecidedNum;
+    }
+    //%}
+
     /// Iterator every element of the condition
     inline NodeBS exactCondElem(const Condition &cond) const {
         NodeBS elems;
@@ -137,9 +234,19 @@ public:
         setNegCondInst(negCond, inst);
         atomConditions.push_back(cond);
         atomConditions.push_back(negCond);
+        _condIdToBDDVar[cond.id()] = newBDDVar(cond, false);
         return cond;
     }
 
+    /// Allocate a BDD variable for an atom
+    inline u32_t newBDDVar(const Condition &atom, bool isTheory) {
+        u32_t var = _bddVarToCond.size();
+        _bddVarToCond.push_back(atom);
+        _bddVarIsTheory.push_back(isTheory);
+        _bdd.newVar();
+        return var;
+    }
+
     inline void setNegCondInst(const Condition &cond, const SVFInstruction *inst) {
         setCondInst(cond, inst);
         _negConds.set(cond.id());
@@ -188,6 +295,12 @@ private:
     /// Allocate path condition for every ICFG Node
     virtual void allocateForICFGNode(const ICFGNode *icfgNode);
 
+    /// Memoized size of an expression (branch conditions first), nullptr if unknown
+    const u32_t *getCachedExprSize(u32_t id) const;
+
+    /// Memoize the size of an expression
+    void cacheExprSize(const Z3Expr &z3Expr, u32_t size);
+
     /// Get/Set a branch condition, and its terminator instruction
     //@{
     /// Set branch condition
@@ -267,13 +380,13 @@ public:
     }
 
     /// Single spatial slicing
-    static void spatialSlicing(const SVFGNode *curEvalSVFGNode, const KeyNodes &keyNodes, Set<u32_t> &temporalSlice,
-                               Set<u32_t> &spatialSlice, Set<u32_t> &callsites);
+    static void spatialSlicing(const SVFGNode *curEvalSVFGNode, const KeyNodes &keyNodes, DenseNodeSet &temporalSlice,
+                               DenseNodeSet &spatialSlice, DenseNodeSet &callsites);
 
     /// Single temporal slicing
     static void
     temporalSlicing(const SVFGNode *curEvalSVFGNode, const KeyNodes &keyNodes, const ICFGNodeWrapper *mainEntry,
-                    Set<u32_t> &temporalSlice, Set<const SVFFunction *> &curEvalFuns);
+                    DenseNodeSet &temporalSlice, Set<const SVFFunction *> &curEvalFuns);
 
     static inline void clearDF() {
         TemporalSlicer::clearDF();
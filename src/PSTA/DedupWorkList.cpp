@@ -0,0 +1,7 @@
+#include "PSTA/DedupWorkList.h"
+
+using namespace SVF;
+
+u32_t WorkListStat::pushNum = 0;
+u32_t WorkListStat::dedupNum = 0;
+u32_t WorkListStat::popNum = 0;
@@ -0,0 +1,88 @@
+#ifndef PSA_DEDUPWORKLIST_H
+#define PSA_DEDUPWORKLIST_H
+
+#include "Util/WorkList.h"
+
+namespace SVF {
+
+/*!
+ * Push/dedup/pop counters shared by all deduplicating worklists
+ *
+ * Plain counters: the solvers using DedupWorkList run on the main thread only
+ */
+class WorkListStat {
+public:
+    static u32_t pushNum;   ///< accepted pushes
+    static u32_t dedupNum;  ///< pushes ignored since the item is already queued
+    static u32_t popNum;    ///< pops
+
+    static inline void reset() {
+        pushNum = 0;
+        dedupNum = 0;
+        popNum = 0;
+    }
+};
+
+/*!
+ * FIFO worklist ignoring pushes of items already queued
+ *
+ * An item may be pushed again once it is popped. Solvers read the current
+ * info of an item when it is popped, so a queued duplicate would only
+ * redo the same evaluation.
+ */
+template<class Data>
+class DedupWorkList {
+    typedef std::deque<Data> DataDeque;
+    typedef Set<Data> DataSet;
+private:
+    DataDeque _dataDeque;
+    DataSet _queued;
+
+public:
+    DedupWorkList() = default;
+
+    ~DedupWorkList() = default;
+
+    inline bool empty() const {
+        return _dataDeque.empty();
+    }
+
+    inline u32_t size() const {
+        assert(_queued.size() == _dataDeque.size() && "worklist and set must be consistent!");
+        return _dataDeque.size();
+    }
+
+    inline bool find(const Data &data) const {
+        return _queued.find(data) != _queued.end();
+    }
+
+    /// Push data to the back, return false if it is already queued
+    inline bool push(const Data &data) {
+        if (!_queued.insert(data).second) {
+            WorkListStat::dedupNum++;
+            return false;
+        }
+        _dataDeque.push_back(data);
+        WorkListStat::pushNum++;
+        return true;
+    }
+
+    /// Pop data from the front
+    inline Data pop() {
+        assert(!empty() && "work list is empty");
+        Data data = _dataDeque.front();
+        _dataDeque.pop_front();
+        _queued.erase(data);
+        WorkListStat::popNum++;
+        return data;
+    }
+
+    inline void clear() {
+        _dataDeque.clear();
+        _queued.clear();
+    }
+};
+
+} // end namespace SVF
+
+#endif //PSA_DEDUPWORKLIST_H
@@ -36,7 +36,31 @@ void FSMHandler::initMainFunc(SVFModule *module) {
         // find the main function entry and save it in _mainEntry and _mainFunc
         if (func->getName() == MAIN) {
             _mainFunc = func;
-            return;
+            break;
+        }
+    }
+    initAnchorNodes();
+}
+
+/*!
+ * Collect the anchor nodes used by every source,
+ * so that per-source initialization does not need to scan the whole ICFG
+ */
+void FSMHandler::initAnchorNodes() {
+    _mainExitNode = nullptr;
+    _mainRetNodes.clear();
+    _progExitCallSites.clear();
+    ICFG *icfg = PAG::getPAG()->getICFG();
+    if (_mainFunc)
+        _mainExitNode = icfg->getFunExitICFGNode(_mainFunc);
+    for (const auto &item: *icfg) {
+        const ICFGNode *icfgNode = item.second;
+        if (const IntraICFGNode *intraBlockNode = dyn_cast<IntraICFGNode>(icfgNode)) {
+            if (intraBlockNode->getFun() == _mainFunc && intraBlockNode->getInst()->isRetInst())
+                _mainRetNodes.insert(icfgNode);
+        } else if (const CallICFGNode *callBlockNode = dyn_cast<CallICFGNode>(icfgNode)) {
+            if (SVFUtil::isProgExitCall(callBlockNode->getCallSite()))
+                _progExitCallSites.insert(callBlockNode);
         }
     }
 }
@@ -55,6 +79,7 @@ void FSMHandler::initSrcs(SrcSet &srcs) {
     _svfg = _svfgBuilder.buildFullSVFG(ander);
     // TODO: add a comment
     if (PSAOptions::CxtSensitiveAlias()) buildInToOuts(_svfg);
+    _svfgAdjacency.init(_svfg);
     // get the FSM parser
     const std::unique_ptr<FSMParser> &fsmParser = FSMParser::getFSMParser();
 
@@ -223,12 +248,17 @@ void FSMHandler::initAbsTransitionFuncs(const SVFGNode *src, Set<const SVFFuncti
     clearICFGAbsTransferMap();
     Log(LogLevel::Info) << "Init abs transition funcs...";
     Dump() << "Init abs transition funcs...";
+    // forward traversal: out edges, plus the actual in -> actual outs jumps when they exist
+    _svfgAdjacency.buildOutEdges();
+    if (PSAOptions::CxtSensitiveAlias()) _svfgAdjacency.packInToOuts(_inToOuts);
     const std::unique_ptr<FSMParser> &fsmParser = FSMParser::getFSMParser();
     PTACallGraph *ptaCallGraph = AndersenWaveDiff::createAndersenWaveDiff(PAG::getPAG())->getPTACallGraph();
     const ICFGNode *srcICFGNode = src->getICFGNode();
     Set<CxtDPItem> workListLayer;
     ContextCond::setMaxCxtLen(PSAOptions::CxtLimit());
     Set<u32_t> visited;
+    /// node claimed through a value-flow summary -> (summary, entry of the node)
+    Map<u32_t, std::pair<const VFSummary *, u32_t>> summaryEntries;
     ContextCond cxt;
     CxtDPItem dpItem(src->getId(), cxt);
     visited.insert(src->getId());
@@ -293,11 +323,62 @@ void FSMHandler::initAbsTransitionFuncs(const SVFGNode *src, Set<const SVFFuncti
                     DBOUT(DGENERAL, outs() << pasMsg("non-transition nodes\n"));
                 }
             }
-            for (const auto &edge: svfgNode->getOutEdges()) {
+            if (recordGlobal && reachGlobal(src)) continue;
+            // intra-procedural successors come from the value-flow summary shared across sources:
+            // a node claimed through a summary continues in it, any other node starts its own
+            const VFSummary *summary = nullptr;
+            u32_t entryId = 0;
+            auto entryIt = summaryEntries.find(item.getCurNodeID());
+            if (entryIt != summaryEntries.end()) {
+                summary = entryIt->second.first;
+                entryId = entryIt->second.second;
+            } else {
+                summary = getOrBuildVFSummary(svfgNode, recordGlobal);
+            }
+            if (summary) {
+                const VFSummaryEntry &entry = summary->entries[entryId];
+                if (entry.reachGlobal) {
+                    reachGlobalNodes.insert(src);
+                    continue;
+                }
+                for (const auto &succ: entry.succs) {
+                    NodeID succId = summary->entries[succ].node->getId();
+                    if (visited.count(succId)) continue;
+                    else visited.insert(succId);
+                    summaryEntries[succId] = std::make_pair(summary, succ);
+                    nxtWorkListLayer.insert(SVFUtil::move(CxtDPItem(succId, item.getContexts())));
+                }
+            } else {
+                // no summary fits in the memo, expand the intra successors one step
+                std::vector<const SVFGNode *> succs;
+                for (const auto &edge: _svfgAdjacency.getOutEdges(svfgNode))
+                    if (edge.isIntra()) succs.push_back(edge.node);
+                // Jump from actual in to its reachable actual outs
+                if (SVFUtil::isa<ActualINSVFGNode>(svfgNode) || SVFUtil::isa<ActualParmVFGNode>(svfgNode)) {
+                    for (const auto &actualout: _svfgAdjacency.getActualOutsOfActualIn(svfgNode))
+                        succs.push_back(actualout);
+                }
+                bool hitGlobal = false;
+                if (recordGlobal) {
+                    for (const auto &dstNode: succs)
+                        if (_svfgBuilder.isGlobalSVFGNode(dstNode)) hitGlobal = true;
+                }
+                if (hitGlobal) {
+                    reachGlobalNodes.insert(src);
+                    continue;
+                }
+                for (const auto &dstNode: succs) {
+                    if (visited.count(dstNode->getId())) continue;
+                    else visited.insert(dstNode->getId());
+                    nxtWorkListLayer.insert(SVFUtil::move(CxtDPItem(dstNode->getId(), item.getContexts())));
+                }
+            }
+            for (const auto &edge: _svfgAdjacency.getOutEdges(svfgNode)) {
+                if (edge.isIntra()) continue;
                 // for indirect SVFGEdge, the propagation should follow the def-use chains
                 // points-to on the edge indicate whether the object of source node can be propagated
 
-                const SVFGNode *dstNode = edge->getDstNode();
+                const SVFGNode *dstNode = edge.node;
                 CxtDPItem newItem(dstNode->getId(), item.getContexts());
 
                 /// handle globals here
@@ -309,34 +390,20 @@ void FSMHandler::initAbsTransitionFuncs(const SVFGNode *src, Set<const SVFFuncti
 
                 /// perform context sensitive reachability
                 // push context for calling
-                if (edge->isCallVFGEdge()) {
-                    FSMParser::FSMAction action = getTypeFromFunc(
-                            edge->getDstNode()->getFun());
-                    if (curEvalFuns.count(edge->getDstNode()->getFun()) || isSrc ||
+                if (edge.isCall()) {
+                    FSMParser::FSMAction action = getTypeFromFunc(dstNode->getFun());
+                    if (curEvalFuns.count(dstNode->getFun()) || isSrc ||
                         (fsmParser->getFSMActions().count(action) && action != FSMParser::CK_DUMMY))
                         continue;
-                    CallSiteID csId = 0;
-                    if (const CallDirSVFGEdge *callEdge = SVFUtil::dyn_cast<CallDirSVFGEdge>(edge))
-                        csId = callEdge->getCallSiteId();
-                    else
-                        csId = SVFUtil::cast<CallIndSVFGEdge>(edge)->getCallSiteId();
-
-                    newItem.pushContext(csId);
+                    newItem.pushContext(edge.csId);
                 }
                     // match context for return
-                else if (edge->isRetVFGEdge()) {
-                    FSMParser::FSMAction action = getTypeFromFunc(
-                            edge->getSrcNode()->getFun());
-                    if (curEvalFuns.count(edge->getSrcNode()->getFun()) || isSrc ||
+                else {
+                    FSMParser::FSMAction action = getTypeFromFunc(svfgNode->getFun());
+                    if (curEvalFuns.count(svfgNode->getFun()) || isSrc ||
                         (fsmParser->getFSMActions().count(action) && action != FSMParser::CK_DUMMY))
                         continue;
-                    CallSiteID csId = 0;
-                    if (const RetDirSVFGEdge *callEdge = SVFUtil::dyn_cast<RetDirSVFGEdge>(edge))
-                        csId = callEdge->getCallSiteId();
-                    else
-                        csId = SVFUtil::cast<RetIndSVFGEdge>(edge)->getCallSiteId();
-
-                    if (newItem.matchContext(csId) == false) continue;
+                    if (newItem.matchContext(edge.csId) == false) continue;
                 }
 
                 /// whether this dstNode has been visited or not
@@ -344,36 +411,16 @@ void FSMHandler::initAbsTransitionFuncs(const SVFGNode *src, Set<const SVFFuncti
                 else visited.insert(newItem.getCurNodeID());
                 nxtWorkListLayer.insert(SVFUtil::move(newItem));
             }
-
-            // Jump from actual in to its reachable actual outs
-            if (SVFUtil::isa<ActualINSVFGNode>(svfgNode) || SVFUtil::isa<ActualParmVFGNode>(svfgNode)) {
-                for (const auto &actualout: getReachableActualOutsOfActualIn(
-                        svfgNode)) {
-                    if (recordGlobal)
-                        if (reachGlobal(src) || _svfgBuilder.isGlobalSVFGNode(actualout)) {
-                            reachGlobalNodes.insert(src);
-                            continue;
-                        }
-                    CxtDPItem newItem(actualout->getId(), item.getContexts());
-                    if (visited.count(newItem.getCurNodeID())) continue;
-                    else visited.insert(newItem.getCurNodeID());
-                    nxtWorkListLayer.insert(SVFUtil::move(newItem));
-                }
-            }
         }
         workListLayer = SVFUtil::move(nxtWorkListLayer);
     }
 
-    for (const auto &item: *(PAG::getPAG()->getICFG())) {
-        const ICFGNode *icfgNode = item.second;
-        if (fsmParser->getFSMActions().count(FSMParser::CK_RET)) {
-            if (const IntraICFGNode *intraBlockNode = dyn_cast<IntraICFGNode>(icfgNode)) {
-                if (intraBlockNode->getFun()->getName() == MAIN && intraBlockNode->getInst()->isRetInst()) {
-                    for (const auto &srcAbsState: fsmParser->getAbsStates()) {
-                        const TypeState &dstAbsState = absStateTransition(srcAbsState, FSMParser::CK_RET);
-                        icfgAbsTransitionFunc[icfgNode].emplace(srcAbsState, dstAbsState);
-                    }
-                }
+    // main's return nodes are indexed once in initAnchorNodes
+    if (fsmParser->getFSMActions().count(FSMParser::CK_RET)) {
+        for (const auto &icfgNode: _mainRetNodes) {
+            for (const auto &srcAbsState: fsmParser->getAbsStates()) {
+                const TypeState &dstAbsState = absStateTransition(srcAbsState, FSMParser::CK_RET);
+                icfgAbsTransitionFunc[icfgNode].emplace(srcAbsState, dstAbsState);
             }
         }
     }
@@ -381,6 +428,88 @@ void FSMHandler::initAbsTransitionFuncs(const SVFGNode *src, Set<const SVFFuncti
     Dump() << SVFUtil::sucMsg("[done]\n");
 }
 
+/*!
+ * Intra-procedural value-flow closure of node, memoized across sources
+ *
+ * The closure only follows intra edges and actual in -> actual out jumps,
+ * so it does not depend on the calling context or on the evaluated source.
+ * Call/ret edges are left to the context-sensitive traversal in initAbsTransitionFuncs.
+ * An entry keeps its successors one BFS step further from the root: an edge to a node
+ * at the same or a smaller distance never claims it first, it is claimed by then.
+ * The memo is bounded by PSAOptions::MaxVFSummaryNodeNum entries in total (0 means unbounded).
+ * A summary that does not fit is dropped (and never rebuilt), memoized ones stay valid.
+ */
+const FSMHandler::VFSummary *FSMHandler::getOrBuildVFSummary(const SVFGNode *node, bool recordGlobal) {
+    VFSummaryKey key = std::make_pair(node->getId(), recordGlobal);
+    auto it = _vfSummaries.find(key);
+    if (it != _vfSummaries.end()) {
+        _vfSummaryHits++;
+        return &it->second;
+    }
+    _vfSummaryMisses++;
+    if (_vfRejectedSummaries.count(key) || (PSAOptions::MaxVFSummaryNodeNum() != 0 &&
+                                            _vfSummaryNodeNum >= PSAOptions::MaxVFSummaryNodeNum()))
+        return nullptr;
+    VFSummary summary;
+    std::vector<u32_t> dists;
+    Map<NodeID, u32_t> entryIds;
+    FIFOWorkList<u32_t> workList;
+    auto addSucc = [&](u32_t curId, const SVFGNode *dstNode) {
+        if (recordGlobal && _svfgBuilder.isGlobalSVFGNode(dstNode)) {
+            summary.entries[curId].reachGlobal = true;
+            return;
+        }
+        auto entryIt = entryIds.find(dstNode->getId());
+        if (entryIt == entryIds.end()) {
+            u32_t dstId = summary.entries.size();
+            summary.entries.push_back(VFSummaryEntry{dstNode});
+            dists.push_back(dists[curId] + 1);
+            entryIds[dstNode->getId()] = dstId;
+            summary.entries[curId].succs.push_back(dstId);
+            workList.push(dstId);
+        } else if (dists[entryIt->second] == dists[curId] + 1) {
+            summary.entries[curId].succs.push_back(entryIt->second);
+        }
+    };
+    summary.entries.push_back(VFSummaryEntry{node});
+    dists.push_back(0);
+    entryIds[node->getId()] = 0;
+    workList.push(0);
+    while (!workList.empty()) {
+        u32_t curId = workList.pop();
+        const SVFGNode *cur = summary.entries[curId].node;
+        // value-flow stops at call sites without callee
+        if (curId != 0 && isCallWithoutCallee(cur)) continue;
+        for (const auto &edge: _svfgAdjacency.getOutEdges(cur)) {
+            if (!edge.isIntra()) continue;
+            addSucc(curId, edge.node);
+        }
+        // Jump from actual in to its reachable actual outs
+        if (SVFUtil::isa<ActualINSVFGNode>(cur) || SVFUtil::isa<ActualParmVFGNode>(cur)) {
+            for (const auto &actualout: _svfgAdjacency.getActualOutsOfActualIn(cur))
+                addSucc(curId, actualout);
+        }
+    }
+    if (PSAOptions::MaxVFSummaryNodeNum() != 0 &&
+        _vfSummaryNodeNum + summary.entries.size() > PSAOptions::MaxVFSummaryNodeNum()) {
+        _vfRejectedSummaries.insert(key);
+        _vfSummaryRejects++;
+        return nullptr;
+    }
+    _vfSummaryNodeNum += summary.entries.size();
+    return &(_vfSummaries[key] = SVFUtil::move(summary));
+}
+
+bool FSMHandler::isCallWithoutCallee(const SVFGNode *node) const {
+    if (SVFUtil::isa<MSSAPHISVFGNode>(node)) return false;
+    const CallICFGNode *callBlockNode = dyn_cast<CallICFGNode>(node->getICFGNode());
+    if (!callBlockNode) return false;
+    Set<const SVFFunction *> functionSet;
+    AndersenWaveDiff::createAndersenWaveDiff(PAG::getPAG())->getPTACallGraph()->getCallees(callBlockNode,
+                                                                                          functionSet);
+    return functionSet.empty();
+}
+
 /*!
  * Init object to ICFG sinks map, e.g., UAFFunc
  */
@@ -420,7 +549,7 @@ FSMHandler::initSnks(const SVFGNode *src, ICFGNodeSet &snks, Set<FSMParser::CHEC
                 }
             }
             if (checkerTypes.find(FSMParser::CK_RET) != checkerTypes.end()) {
-                if (intraICFGNode->getFun()->getName() == MAIN && intraICFGNode->getInst()->isRetInst()) {
+                if (isMainRetNode(intraICFGNode)) {
                     snks.insert(mpItem.first);
                 }
             }
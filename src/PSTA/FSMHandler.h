@@ -13,6 +13,7 @@
 #include "Graphs/SVFG.h"
 #include <SABER/SaberSVFGBuilder.h>
 #include "AE/Core/SymState.h"
+#include "PSTA/SVFGAdjacency.h"
 
 #define CHECKERAPI_JSON_PATH "/src/PSTA/CheckerAPI.json"
 
@@ -166,11 +167,33 @@ public:
     typedef Map<TypeState, TypeState> TransferFunc;
     typedef OrderedMap<const ICFGNode *, TransferFunc> ICFGAbsTransitionFunc;
     typedef OrderedSet<const ICFGNode *> ICFGNodeSet;
+    typedef std::pair<NodeID, bool> VFSummaryKey;
+
+    /// A node of a value-flow summary
+    struct VFSummaryEntry {
+        const SVFGNode *node;
+        std::vector<u32_t> succs; ///< entries one step further from the root, reached from this node
+        bool reachGlobal{false};  ///< whether a global SVFG node is met from this node (only when globals are recorded)
+    };
+
+    /*!
+     * Intra-procedural value-flow closure of a SVFG node
+     *
+     * Nodes reachable without crossing call/ret edges (actual in -> actual out jumps included)
+     * in BFS order from the root (entries[0]), shared by all sources evaluated in one run.
+     * Only the edges leading one step further from the root are kept, so walking the summary
+     * claims each node in the same BFS layer as walking the SVFG edges does.
+     */
+    struct VFSummary {
+        std::vector<VFSummaryEntry> entries;
+    };
+    typedef Map<VFSummaryKey, VFSummary> VFSummaryMap;
 
 private:
     static std::unique_ptr<FSMHandler> absTransitionHandler;
     SaberSVFGBuilder _svfgBuilder;
     SVFG *_svfg{nullptr};
+    SVFGAdjacency _svfgAdjacency; ///< CSR edges and actual in -> actual outs of _svfg
 
     FSMHandler() = default;
 
@@ -179,6 +202,13 @@ private:
     Set<const SVFGNode *> reachGlobalNodes; ///< Abstract state transfer function for each ICFG node
     const SVFFunction* _mainFunc{nullptr};
 
+    /// Module-level anchor nodes, collected once in initAnchorNodes
+    //{%
+    const ICFGNode *_mainExitNode{nullptr};    ///< exit node of main
+    ICFGNodeSet _mainRetNodes;                 ///< intra nodes holding main's return instructions
+    CallSiteSet _progExitCallSites;            ///< call sites of program exit functions (e.g., exit, abort)
+    //%}
+
 public:
 
     /// Singleton
@@ -189,12 +219,39 @@ public:
         return absTransitionHandler;
     }
 
+    /// Release the module state (SVFG, anchors, summaries), the FSMParser is kept
+    static inline void releaseAbsTransitionHandler() {
+        absTransitionHandler = nullptr;
+    }
+
     void initMainFunc(SVFModule *module);
 
     inline const SVFFunction* getMainFunc() const {
         return _mainFunc;
     }
 
+    /// Index anchor nodes (main exit/ret, program exit call sites) in one pass over the ICFG
+    void initAnchorNodes();
+
+    /// Anchor nodes
+    //{%
+    inline const ICFGNode *getMainExitNode() const {
+        return _mainExitNode;
+    }
+
+    inline const ICFGNodeSet &getMainRetNodes() const {
+        return _mainRetNodes;
+    }
+
+    inline bool isMainRetNode(const ICFGNode *node) const {
+        return _mainRetNodes.find(node) != _mainRetNodes.end();
+    }
+
+    inline const CallSiteSet &getProgExitCallSites() const {
+        return _progExitCallSites;
+    }
+    //%}
+
     /// Identify allocation wrappers
     void initSrcs(SrcSet &srcs);
 
@@ -224,6 +281,29 @@ public:
         return reachGlobalNodes.find(svfgNode) != reachGlobalNodes.end();
     }
 
+    /// Value-flow summary statistics
+    //{%
+    inline u32_t getVFSummaryNum() const {
+        return _vfSummaries.size();
+    }
+
+    inline u32_t getVFSummaryHitNum() const {
+        return _vfSummaryHits;
+    }
+
+    inline u32_t getVFSummaryMissNum() const {
+        return _vfSummaryMisses;
+    }
+
+    inline u32_t getVFSummaryRejectNum() const {
+        return _vfSummaryRejects;
+    }
+
+    inline u32_t getVFSummaryNodeNum() const {
+        return _vfSummaryNodeNum;
+    }
+    //%}
+
 public:
 
     void buildOutToIns(SVFG *svfg);
@@ -238,6 +318,14 @@ public:
         return _inToOuts[actualIn];
     }
 
+    inline const SVFGAdjacency::JumpMap &getOutToIns() const {
+        return _outToIns;
+    }
+
+    inline const SVFGAdjacency &getSVFGAdjacency() const {
+        return _svfgAdjacency;
+    }
+
 public:
     /// Get the function type of a function
     inline FSMParser::FSMAction getTypeFromFunc(const SVFFunction *func) const {
@@ -255,10 +343,22 @@ private:
 
     void computeInToOuts(const SVFGNode *src, Set<const SVFGNode *> &visitedIns);
 
+    /// Get (or compute and memoize) the intra-procedural value-flow closure of node, nullptr if it does not fit
+    const VFSummary *getOrBuildVFSummary(const SVFGNode *node, bool recordGlobal);
+
+    /// Whether node sits on a call site without any resolved callee (value-flow stops there)
+    bool isCallWithoutCallee(const SVFGNode *node) const;
+
 private:
     Map<u32_t, Set<const SVFVar *>> _formalParamToVars;
     Map<const SVFGNode *, Set<const SVFGNode *>> _outToIns; // maps an actual out/ret SVFGNode to its reachable actual in/param SVFGNodes
     Map<const SVFGNode *, Set<const SVFGNode *>> _inToOuts; // maps an actual out/ret SVFGNode to its reachable actual in/param SVFGNodes
+    VFSummaryMap _vfSummaries; ///< (SVFG node, record global) -> intra-procedural value-flow closure, kept across sources
+    Set<VFSummaryKey> _vfRejectedSummaries; ///< summaries that do not fit in the memo, never rebuilt
+    u32_t _vfSummaryNodeNum{0}; ///< total number of entries in _vfSummaries
+    u32_t _vfSummaryHits{0};
+    u32_t _vfSummaryMisses{0};
+    u32_t _vfSummaryRejects{0};
 
 }; // end class FSMHandler
 } // end namespace SVF
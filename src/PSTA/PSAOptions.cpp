@@ -99,6 +99,54 @@ const Option<bool> PSAOptions::Base(
         "base",
         "baseline solver and detector",
         false);
+const Option<bool> PSAOptions::TwoPhase(
+        "two-phase",
+        "Run a path-insensitive typestate pre-pass and skip path-sensitive solving for srcs proved safe (uaf/df)",
+        false);
+const Option<bool> PSAOptions::InfoSlots(
+        "info-slots",
+        "Store ESP infos in per-edge slot arrays indexed by interned typestate during solving",
+        false);
+const Option<bool> PSAOptions::LiveProjection(
+        "live-proj",
+        "Drop dead top-level variables from execution states at merge points and function exits",
+        false);
+const Option<bool> PSAOptions::DeltaProp(
+        "delta-prop",
+        "Only propagate what changed: skip merge nodes whose joined in-state is unchanged and callsites whose summary entry is unchanged",
+        false);
+const Option<bool> PSAOptions::BlockWrapper(
+        "block-wrapper",
+        "Collapse straight-line chains of the compacted ICFGWrapper into super-nodes",
+        false);
+const Option<bool> PSAOptions::RebuildCompaction(
+        "rebuild-compact",
+        "Compact the ICFGWrapper in one pass over the kept nodes instead of node-by-node",
+        false);
+const Option<bool> PSAOptions::LazyWrapper(
+        "lazy-wrapper",
+        "Materialize ICFGWrapper functions on demand instead of cloning the whole ICFG",
+        false);
+const Option<bool> PSAOptions::DepClosure(
+        "dep-closure",
+        "Memoize backward dependence closures of spatial slicing across srcs",
+        false);
+const Option<bool> PSAOptions::Batch(
+        "batch",
+        "Analyze each input bitcode as its own module in a child process, writing per-module reports under -o",
+        false);
+const Option<bool> PSAOptions::EagerError(
+        "eager-err",
+        "Record bugs at the error transition and stop propagating error states",
+        false);
+const Option<bool> PSAOptions::SnkDirected(
+        "snk-directed",
+        "Prune propagation into nodes that cannot reach any snk or program exit",
+        false);
+const Option<bool> PSAOptions::BDDPathCond(
+        "bdd-path-cond",
+        "Represent branch path conditions as BDDs (Z3 is still used for data constraints)",
+        false);
 const Option<bool> PSAOptions::DumpState(
         "dump-stat",
         "dump stat to file",
@@ -141,6 +189,42 @@ const Option<u32_t> PSAOptions::MaxAddrs(
         "max-addrs",
         "Maximum addrs",
         20);
+const Option<u32_t> PSAOptions::Z3RecycleNum(
+        "z3-recycle",
+        "Recycle the Z3 context every N srcs to bound solver memory (0: never recycle)",
+        0);
+const Option<u32_t> PSAOptions::MaxExprSizeCache(
+        "max-expr-size-cache",
+        "Maximum number of memoized Z3 expression sizes (0: unbounded)",
+        100000);
+const Option<u32_t> PSAOptions::MaxSimplifyCache(
+        "max-simplify-cache",
+        "Maximum number of memoized path condition simplifications and BDD translations (0: unbounded)",
+        100000);
+const Option<u32_t> PSAOptions::MaxVFSummaryNodeNum(
+        "max-vf-summary",
+        "Maximum number of SVFG nodes in memoized value-flow summaries shared across srcs (0: unbounded)",
+        100000);
+const Option<u32_t> PSAOptions::SSlicingThreads(
+        "sslice-threads",
+        "Number of threads expanding each spatial slicing layer (0/1: sequential)",
+        0);
+const Option<u32_t> PSAOptions::MaxDepClosureNodeNum(
+        "max-dep-closure",
+        "Maximum number of nodes in memoized dependence closures shared across srcs (0: unbounded)",
+        1000000);
+const Option<u32_t> PSAOptions::CDGThreads(
+        "cdg-threads",
+        "Number of threads computing per-function control dependence (0/1: sequential)",
+        0);
+const Option<u32_t> PSAOptions::TPSThreads(
+        "tps-threads",
+        "Number of threads solving the PIs of a source in temporal slicing (0/1: sequential)",
+        0);
+const Option<u32_t> PSAOptions::CSRThreads(
+        "csr-threads",
+        "Number of threads packing the SVFG adjacency (0/1: sequential)",
+        0);
 const Option<std::string> PSAOptions::LogLevel(
         "log-level",
         "print log level",
@@ -155,6 +239,10 @@ const Option<std::string> PSAOptions::OUTPUT("o",
                                              "output dir",
                                              "report/");
 
+const Option<std::string> PSAOptions::BatchList("batch-list",
+                                                "file listing one input bitcode per line, implies -batch",
+                                                "");
+
 }
 
 
@@ -38,6 +38,18 @@ public:
     static const Option<bool> UAF;
     static const Option<bool> DF;
     static const Option<bool> Base;
+    static const Option<bool> TwoPhase;
+    static const Option<bool> BDDPathCond;
+    static const Option<bool> SnkDirected;
+    static const Option<bool> EagerError;
+    static const Option<bool> InfoSlots;
+    static const Option<bool> LiveProjection;
+    static const Option<bool> DeltaProp;
+    static const Option<bool> BlockWrapper;
+    static const Option<bool> RebuildCompaction;
+    static const Option<bool> LazyWrapper;
+    static const Option<bool> DepClosure;
+    static const Option<bool> Batch;
 
     static const Option<u32_t> MaxSnkLimit;
     static const Option<u32_t> MaxSrcLimit;
@@ -47,11 +59,21 @@ public:
     static const Option<u32_t> MaxSQSize;
     static const Option<u32_t> EvalNode;
     static const Option<u32_t> MaxAddrs;
+    static const Option<u32_t> MaxVFSummaryNodeNum;
+    static const Option<u32_t> SSlicingThreads;
+    static const Option<u32_t> MaxDepClosureNodeNum;
+    static const Option<u32_t> CDGThreads;
+    static const Option<u32_t> TPSThreads;
+    static const Option<u32_t> CSRThreads;
+    static const Option<u32_t> Z3RecycleNum;
+    static const Option<u32_t> MaxExprSizeCache;
+    static const Option<u32_t> MaxSimplifyCache;
 
     static const Option<std::string> LogLevel;
 
     static const Option<std::string> FSMFILE;
     static const Option<std::string> OUTPUT;
+    static const Option<std::string> BatchList;
 
 };
 }
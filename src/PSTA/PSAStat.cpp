@@ -51,6 +51,10 @@ void PSAStat::performStat(string model) {
 //    paramNumMap["ExeState"] = PSAOptions::ExeStateType();
     paramNumMap["Max Step In Wrapper"] = PSAOptions::MaxStepInWrapper();
     paramNumMap["Spatial Layer Num"] = PSAOptions::LayerNum();
+    paramNumMap["Two Phase"] = PSAOptions::TwoPhase();
+    paramNumMap["BDD Path Cond"] = PSAOptions::BDDPathCond();
+    paramNumMap["Snk Directed"] = PSAOptions::SnkDirected();
+    paramNumMap["Z3 Recycle Interval"] = PSAOptions::Z3RecycleNum();
 
 
     timeStatMap["InitSrc"] = (getsrcEndTime - getsrcStartTime) / TIMEINTERVAL;
@@ -76,6 +80,14 @@ void PSAStat::performStat(string model) {
             std::accumulate(_varAddrSetAvgSZ.begin(), _varAddrSetAvgSZ.end(), 0.0) / _varAddrSetAvgSZ.size();
     generalNumMap["Loc AddrSet Avg Size"] =
             std::accumulate(_locAddrSetAvgSZ.begin(), _locAddrSetAvgSZ.end(), 0.0) / _locAddrSetAvgSZ.size();
+    if (!_uniqueExeStateNums.empty()) {
+        generalNumMap["Shared ExeState Avg Num"] =
+                std::accumulate(_sharedExeStateNums.begin(), _sharedExeStateNums.end(), 0.0) /
+                _sharedExeStateNums.size();
+        generalNumMap["Unique ExeState Avg Num"] =
+                std::accumulate(_uniqueExeStateNums.begin(), _uniqueExeStateNums.end(), 0.0) /
+                _uniqueExeStateNums.size();
+    }
 
 
     generalNumMap["Info Map Avg Size"] =
@@ -103,6 +115,47 @@ void PSAStat::performStat(string model) {
     }
     generalNumMap["ICFG Edge Num"] = icfgEdges.size();
     generalNumMap["Branch Num"] = esp->getPathAllocator()->getIcfgNodeCondsNum();
+    if (PSAOptions::BDDPathCond()) {
+        generalNumMap["BDD Var Num"] = esp->getPathAllocator()->getPathCondBDD().getVarNum();
+        generalNumMap["BDD Node Num"] = esp->getPathAllocator()->getPathCondBDD().getTotalNodeNum();
+        generalNumMap["BDD Reset Num"] = esp->getPathAllocator()->getBDDResetNum();
+        generalNumMap["BDD Decided Num"] = esp->getPathAllocator()->getBDDDecidedNum();
+    }
+
+    const std::unique_ptr<FSMHandler> &fsmHandler = esp->getAbsTransitionHandler();
+    u32_t vfSummaryQueries = fsmHandler->getVFSummaryHitNum() + fsmHandler->getVFSummaryMissNum();
+    generalNumMap["VF Summary Num"] = fsmHandler->getVFSummaryNum();
+    generalNumMap["VF Summary Node Num"] = fsmHandler->getVFSummaryNodeNum();
+    generalNumMap["VF Summary Hit Num"] = fsmHandler->getVFSummaryHitNum();
+    generalNumMap["VF Summary Miss Num"] = fsmHandler->getVFSummaryMissNum();
+    generalNumMap["VF Summary Reject Num"] = fsmHandler->getVFSummaryRejectNum();
+    generalNumMap["VF Summary Hit Rate(%)"] =
+            vfSummaryQueries == 0 ? 0 : fsmHandler->getVFSummaryHitNum() * 100 / vfSummaryQueries;
+
+    // CSR adjacency of the SVFGs of the solver and of spatial slicing
+    generalNumMap["SVFG CSR Memory(KB)"] =
+            (fsmHandler->getSVFGAdjacency().getMemoryBytes() +
+             esp->_graphSparsificator._spatialSlicer.getSVFGAdjacency().getMemoryBytes()) / 1024;
+
+    if (PSAOptions::DepClosure()) {
+        const SpatialSlicer &spatialSlicer = esp->_graphSparsificator._spatialSlicer;
+        u32_t closureQueries = spatialSlicer.getDepClosureHitNum() + spatialSlicer.getDepClosureMissNum();
+        generalNumMap["Dep Closure Num"] = spatialSlicer.getDepClosureNum();
+        generalNumMap["Dep Closure Node Num"] = spatialSlicer.getDepClosureNodeNum();
+        generalNumMap["Dep Closure Hit Num"] = spatialSlicer.getDepClosureHitNum();
+        generalNumMap["Dep Closure Miss Num"] = spatialSlicer.getDepClosureMissNum();
+        generalNumMap["Dep Closure Reject Num"] = spatialSlicer.getDepClosureRejectNum();
+        generalNumMap["Dep Closure Hit Rate(%)"] =
+                closureQueries == 0 ? 0 : spatialSlicer.getDepClosureHitNum() * 100 / closureQueries;
+    }
+
+    ExeStateManager *exeStateMgr = ExeStateManager::getExeStateMgr();
+    u32_t simplifyQueries = exeStateMgr->getSimplifyHitNum() + exeStateMgr->getSimplifyMissNum();
+    generalNumMap["Simplify Fast Path Num"] = exeStateMgr->getSimplifyFastPathNum();
+    generalNumMap["Simplify Cache Hit Num"] = exeStateMgr->getSimplifyHitNum();
+    generalNumMap["Simplify Cache Miss Num"] = exeStateMgr->getSimplifyMissNum();
+    generalNumMap["Simplify Cache Hit Rate(%)"] =
+            simplifyQueries == 0 ? 0 : exeStateMgr->getSimplifyHitNum() * 100 / simplifyQueries;
 
     if (!PSAOptions::MultiSlicing()) {
         timeStatMap["Collecting Call Time"] = triggerCallTotalTime / TIMEINTERVAL;
@@ -160,6 +213,27 @@ void PSAStat::performStat(string model) {
         timeStatMap["Callsites Time"] = ncExtractTotalTime / TIMEINTERVAL;
     }
     generalNumMap["Bug Num"] = _bugNum;
+    generalNumMap["Graph Unreachable Snk Num"] = _graphUnreachableSnkNum;
+    if (PSAOptions::SnkDirected())
+        generalNumMap["Pruned Propagation Num"] = _prunedPropagationNum;
+    generalNumMap["WorkList Push Num"] = WorkListStat::pushNum;
+    generalNumMap["WorkList Dedup Num"] = WorkListStat::dedupNum;
+    generalNumMap["WorkList Pop Num"] = WorkListStat::popNum;
+    if (PSAOptions::BlockWrapper())
+        generalNumMap["Block Merged Node Num"] = _blockMergedNodeNum;
+    if (PSAOptions::DeltaProp()) {
+        generalNumMap["Delta Skipped Push Num"] = _deltaSkippedPushNum;
+        generalNumMap["Delta Skipped Merge Num"] = _deltaSkippedMergeNum;
+    }
+    if (PSAOptions::LiveProjection()) {
+        generalNumMap["Live Dropped Var Num"] = _liveDroppedVarNum;
+        generalNumMap["Live Proj Reduction(%)"] =
+                _liveProjVarNum == 0 ? 0 : _liveDroppedVarNum * 100 / _liveProjVarNum;
+    }
+    if (PSAOptions::TwoPhase())
+        generalNumMap["Pre-pass Safe Src Num"] = _safeSrcNum;
+    if (PSAOptions::Z3RecycleNum() != 0)
+        generalNumMap["Z3 Recycle Num"] = _z3RecycleNum;
 
     timeStatMap["TotalTime"] = (endTime - startTime) / TIMEINTERVAL;
 
@@ -270,6 +344,15 @@ void PSAStat::collectCompactedGraphStats() {
     }
     _nodeNums.push_back(visited.size());
     _edgeNums.push_back(visitedEdge.size());
+    // compaction throughput so far
+    double compactGraphTime = compactGraphTotalTime / TIMEINTERVAL;
+    generalNumMap["Compact Scanned Node Num"] = _compactScannedNodeNum;
+    generalNumMap["Compact Throughput(nodes/s)"] =
+            compactGraphTime == 0 ? 0 : _compactScannedNodeNum / compactGraphTime;
+    // wrapper size, peak over all the srcs
+    generalNumMap["Peak Wrapper Node Num"] = ICFGWrapper::getPeakNodeWrapperNum();
+    if (PSAOptions::LazyWrapper())
+        generalNumMap["Lazy Expanded Fun Num"] = ICFGWrapper::getMaterializedFunNum();
 
     Set<const ICFGEdgeWrapper *> infoEdge;
     Set<const SVFFunction *> summaryFunc;
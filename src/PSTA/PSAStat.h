@@ -74,8 +74,19 @@ private:
     std::string memUsage;
 
     std::vector<u32_t> _nodeNums, _edgeNums, _infoMapSzs, _summaryMapSzs;
+    std::vector<u32_t> _sharedExeStateNums, _uniqueExeStateNums; ///< copy-on-write sharing of info slots (-info-slots)
     std::vector<double> _varAvgSZ, _locAvgSZ, _varAddrAvgSZ, _locAddrAvgSZ, _varAddrSetAvgSZ, _locAddrSetAvgSZ;
     u32_t _bugNum{0};
+    u32_t _safeSrcNum{0};    ///< srcs proved safe by the typestate pre-pass (two-phase mode)
+    u32_t _z3RecycleNum{0};  ///< times the Z3 context is recycled
+    u32_t _graphUnreachableSnkNum{0}; ///< snks skipped by the graph-reachability pre-check
+    u32_t _prunedPropagationNum{0};   ///< propagations dropped by sink-directed pruning
+    u32_t _liveProjVarNum{0};         ///< vars in the states before liveness projection
+    u32_t _liveDroppedVarNum{0};      ///< dead vars dropped by liveness projection
+    u32_t _deltaSkippedPushNum{0};    ///< callsite re-analyses skipped by delta propagation
+    u32_t _deltaSkippedMergeNum{0};   ///< merge node re-evaluations skipped by delta propagation
+    u32_t _blockMergedNodeNum{0};     ///< wrapper nodes folded into super-nodes
+    u32_t _compactScannedNodeNum{0};  ///< wrapper nodes fed to graph compaction
 
 
 public:
@@ -200,6 +211,52 @@ public:
         _bugNum++;
     }
 
+    inline void incSafeSrcNum() {
+        _safeSrcNum++;
+    }
+
+    inline void incZ3RecycleNum() {
+        _z3RecycleNum++;
+    }
+
+    inline void incGraphUnreachableSnkNum() {
+        _graphUnreachableSnkNum++;
+    }
+
+    inline void incPrunedPropagationNum() {
+        _prunedPropagationNum++;
+    }
+
+    inline void addCompactScannedNodeNum(u32_t num) {
+        _compactScannedNodeNum += num;
+    }
+
+    inline void addBlockMergedNodeNum(u32_t num) {
+        _blockMergedNodeNum += num;
+    }
+
+    inline void incDeltaSkippedPushNum() {
+        _deltaSkippedPushNum++;
+    }
+
+    inline void incDeltaSkippedMergeNum() {
+        _deltaSkippedMergeNum++;
+    }
+
+    inline void addLiveProjVarNum(u32_t num) {
+        _liveProjVarNum += num;
+    }
+
+    inline void addLiveDroppedVarNum(u32_t num) {
+        _liveDroppedVarNum += num;
+    }
+
+    /// Record the slots sharing a symstate and the distinct symstates of one src
+    inline void recordExeStateSharing(u32_t sharedNum, u32_t uniqueNum) {
+        _sharedExeStateNums.push_back(sharedNum);
+        _uniqueExeStateNums.push_back(uniqueNum);
+    }
+
 };
 }
 
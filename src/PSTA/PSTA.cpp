@@ -8,6 +8,7 @@
 #include "Slicing/ControlDG.h"
 #include "PSTA/PSAStat.h"
 #include "PSTA/BTPExtractor.h"
+#include "PSTA/SNKExtractor.h"
 #include <queue>
 #include <numeric>
 #include "PSTA/Logger.h"
@@ -27,6 +28,7 @@ PSTA::PSTA() : _stat(new PSAStat(this)), _graphSparsificator() {
 
 PSTA::~PSTA() {
     _infoMap.clear();
+    _mergeStamps.clear();
     delete _stat;
     _stat = nullptr;
     ControlDG::releaseControlDG();
@@ -40,6 +42,14 @@ PSTA::~PSTA() {
  */
 void PSTA::initialize(SVFModule *module) {
     PSTABase::initialize(module);
+    // Intern typestates for info slots
+    _typeStates.assign(getFSMParser()->getAbsStates().begin(), getFSMParser()->getAbsStates().end());
+    _typeStateIds.clear();
+    for (u32_t i = 0; i < _typeStates.size(); ++i) {
+        u32_t value = static_cast<u32_t>(_typeStates[i]);
+        if (value >= _typeStateIds.size()) _typeStateIds.resize(value + 1, UINT32_MAX);
+        _typeStateIds[value] = i;
+    }
     // Allocate branch condition
     Log(LogLevel::Info) << "Allocating branch condition...";
     Dump() << "Allocating branch condition...";
@@ -47,17 +57,27 @@ void PSTA::initialize(SVFModule *module) {
     getPathAllocator()->allocate();
     Log(LogLevel::Info) << SVFUtil::sucMsg("[done]\n");
     Dump() << SVFUtil::sucMsg("[done]\n");
+    // Dense ICFG node ids for slice sets
+    DenseIDMap::getICFGIDMap().build(_icfg);
     _stat->wrapStart();
     // Clone ICFG to ICFGWrapper
     ICFGWrapperBuilder icfgWrapperBuilder;
-    icfgWrapperBuilder.build(_icfg);
+    if (PSAOptions::LazyWrapper())
+        icfgWrapperBuilder.buildLazy(_icfg, {});
+    else
+        icfgWrapperBuilder.build(_icfg);
     _stat->wrapEnd();
 }
 
 void PSTA::initHandler(SVFModule *module) {
     ICFGWrapperBuilder builder;
     ICFG *icfg = PAG::getPAG()->getICFG();
-    builder.build(icfg);
+    if (PSAOptions::LazyWrapper()) {
+        Set<const SVFFunction *> demandFuns;
+        ICFGWrapperBuilder::collectDemandFuns(_curEvalICFGNode, _curEvalFuns, {}, demandFuns);
+        builder.buildLazy(icfg, demandFuns);
+    } else
+        builder.build(icfg);
     _graphSparsificator.clearItems();
 }
 
@@ -67,7 +87,9 @@ void PSTA::initHandler(SVFModule *module) {
  */
 void PSTA::initMap(SVFModule *module) {
     _infoMap.clear();
+    _mergeStamps.clear();
     _summaryMap.clear();
+    _symStateMgr.clearErrFindings();
 }
 
 /*!
@@ -85,6 +107,11 @@ void PSTA::analyze(SVFModule *module) {
     int solveCt = 0;
     // iterate each src and run the solver
     for (const auto &item: _srcs) {
+        // Bound solver memory by recycling Z3 context every Z3RecycleNum srcs
+        if (PSAOptions::Z3RecycleNum() != 0 && solveCt != 0 && solveCt % PSAOptions::Z3RecycleNum() == 0) {
+            recycleZ3Context();
+            _stat->incZ3RecycleNum();
+        }
         // Set current evaluated SVFG and ICFG node
         _curEvalSVFGNode = item;
         _curEvalICFGNode = item->getICFGNode();
@@ -127,10 +154,30 @@ void PSTA::analyze(SVFModule *module) {
             _graphSparsificator.compactGraph(_curEvalSVFGNode, _curEvalICFGNode, _curEvalFuns, _mainEntry, _snks);
             _stat->compactGraphEnd();
         }
+        // the solvers below read the wrapper without materializing, close it under traversals from main
+        if (getICFGWrapper()->isLazy()) {
+            const ICFGNodeWrapper *mainEntry = getICFGWrapper()->getICFGNodeWrapper(_mainEntry->getId());
+            getICFGWrapper()->materializeReachable({mainEntry}, true);
+            getICFGWrapper()->freeze();
+        }
         if (PSAOptions::DumpICFGWrapper())
             continue;
+        // Two-phase mode: skip the path-sensitive solver if no snk can reach the error typestate
+        if (PSAOptions::TwoPhase() && !_symStateMgr.hasCheckerType(FSMParser::CK_RET) &&
+            isSafeByTypestate(module)) {
+            _stat->incSafeSrcNum();
+            Log(LogLevel::Info) << SVFUtil::sucMsg("[safe] src at (" + _curEvalSVFGNode->getValue()->getSourceLoc() +
+                                                   ") proved by typestate pre-pass\n");
+            Dump() << SVFUtil::sucMsg("[safe] src at (" + _curEvalSVFGNode->getValue()->getSourceLoc() +
+                                      ") proved by typestate pre-pass\n");
+            Log(LogLevel::Info) << "-------------------------------------------------------\n";
+            Dump() << "-------------------------------------------------------\n";
+            continue;
+        }
         initMap(module);
+        buildSnkDirectedMask();
         solve();
+        buildSrcReachability();
         _stat->collectCompactedGraphStats();
         if (PSAOptions::PrintPathCond())
             printSS();
@@ -143,6 +190,122 @@ void PSTA::analyze(SVFModule *module) {
     _stat->solveEnd();
 }
 
+/*!
+ * Phase one of the two-phase mode
+ *
+ * Run the path-insensitive typestate propagation of SNKExtractor over the compacted graph.
+ * The pre-pass over-approximates the path-sensitive solver, so if none of the current snks
+ * can reach the error typestate, the source is safe and PSTA::solve can be skipped.
+ * Only for checkers whose snks are call sites (uaf/df): leak errors come from the summary
+ * of main and the program exit paths, which the pre-pass does not model.
+ * @param module
+ * @return true if the source is proved safe
+ */
+bool PSTA::isSafeByTypestate(SVFModule *module) {
+    ICFGNodeWrapper *srcWrapper = getICFGWrapper()->getICFGNodeWrapper(_curEvalICFGNode->getId());
+    // src is removed when compacting graph, nothing to report
+    if (!srcWrapper || srcWrapper->getInEdges().empty()) return true;
+    ICFGNodeSet errSnks = _snks;
+    SNKExtractor snkExtractor;
+    snkExtractor.extract(module, _curEvalSVFGNode, errSnks);
+    return errSnks.empty();
+}
+
+/*!
+ * Recycle the Z3 context
+ *
+ * Branch conditions are allocated under the old context, so they are released
+ * before the context and allocated again afterwards (allocation is deterministic)
+ */
+void PSTA::recycleZ3Context() {
+    _infoMap.clear();
+    _mergeStamps.clear();
+    _symStateMgr.clearErrFindings();
+    BranchAllocator::releaseCondAllocator();
+    PSTABase::recycleZ3Context();
+    getPathAllocator()->allocate();
+}
+
+/*!
+ * Build the graph-reachability index of the current src
+ *
+ * All reachability queries of reportBug share the current src as the source,
+ * so one forward traversal over the compacted wrapper answers them in O(1)
+ */
+void PSTA::buildSrcReachability() {
+    _srcReachableNodes.clear();
+    const ICFGNodeWrapper *srcWrapper = getICFGWrapper()->getICFGNodeWrapper(_curEvalICFGNode->getId());
+    if (!srcWrapper) return;
+    FIFOWorkList<const ICFGNodeWrapper *> workList;
+    workList.push(srcWrapper);
+    _srcReachableNodes.set(srcWrapper->getId());
+    while (!workList.empty()) {
+        const ICFGNodeWrapper *cur = workList.pop();
+        for (const auto &e: cur->getOutEdges()) {
+            if (_srcReachableNodes.test_and_set(e->getDstID()))
+                workList.push(e->getDstNode());
+        }
+        // call node with its callee compacted
+        if (const ICFGNodeWrapper *retNode = cur->getRetICFGNodeWrapper()) {
+            if (_srcReachableNodes.test_and_set(retNode->getId()))
+                workList.push(retNode);
+        }
+    }
+}
+
+/*!
+ * Build the backward-reachability mask of the current src
+ *
+ * Targets are the snks, plus the exit/ret nodes of main and the program exit call sites for leak (CK_RET).
+ * A node outside the mask cannot reach any target, so states flowing into it never
+ * show up in reportBug. Successors of targets are kept since bugs are read on their out edges.
+ */
+void PSTA::buildSnkDirectedMask() {
+    _snkDirectedMask.clear();
+    if (!PSAOptions::SnkDirected()) return;
+    std::vector<const ICFGNodeWrapper *> targets;
+    auto addTarget = [&](const ICFGNode *node) {
+        if (!node) return;
+        if (const ICFGNodeWrapper *nodeWrapper = getICFGWrapper()->getICFGNodeWrapper(node->getId()))
+            targets.push_back(nodeWrapper);
+    };
+    for (const auto &snk: _snks) {
+        addTarget(snk);
+        if (const CallICFGNode *callNode = SVFUtil::dyn_cast<CallICFGNode>(snk))
+            addTarget(callNode->getRetICFGNode());
+    }
+    // leak errors are read at the end of main and at program exits
+    if (_symStateMgr.hasCheckerType(FSMParser::CK_RET)) {
+        addTarget(getAbsTransitionHandler()->getMainExitNode());
+        for (const auto &retNode: getAbsTransitionHandler()->getMainRetNodes())
+            addTarget(retNode);
+        for (const auto &callNode: getAbsTransitionHandler()->getProgExitCallSites())
+            addTarget(callNode);
+    }
+
+    FIFOWorkList<const ICFGNodeWrapper *> workList;
+    for (const auto &target: targets) {
+        if (_snkDirectedMask.test_and_set(target->getId()))
+            workList.push(target);
+    }
+    while (!workList.empty()) {
+        const ICFGNodeWrapper *cur = workList.pop();
+        for (const auto &e: cur->getInEdges()) {
+            if (_snkDirectedMask.test_and_set(e->getSrcID()))
+                workList.push(e->getSrcNode());
+        }
+        // ret node of a call node with its callee compacted
+        if (const ICFGNodeWrapper *callNode = cur->getCallICFGNodeWrapper()) {
+            if (_snkDirectedMask.test_and_set(callNode->getId()))
+                workList.push(callNode);
+        }
+    }
+    for (const auto &target: targets) {
+        for (const auto &e: target->getOutEdges())
+            _snkDirectedMask.set(e->getDstID());
+    }
+}
+
 /*!
  * Main algorithm
  */
@@ -168,6 +331,11 @@ void PSTA::solve() {
                 processCallNodeIso(callBlockNode, curItem);
             else
                 processCallNode(callBlockNode, curItem);
+        } else if (PSAOptions::DeltaProp() && isMergeNode(curItem.getICFGNodeWrapper()) &&
+                   !hasMergeDelta(curItem)) {
+            // Nothing new joined at the merge node (e.g., a loop head),
+            // its out edges already hold the infos it would produce
+            _stat->incDeltaSkippedMergeNum();
         } else if (isExitNode(curItem.getICFGNodeWrapper())) {
             // Process FunExitICFGNode
             //
@@ -191,6 +359,42 @@ void PSTA::solve() {
             processOtherNode(curItem);
         }
     }
+    if (PSAOptions::InfoSlots())
+        flushInfoSlots();
+}
+
+/*!
+ * Move the infos in per-edge slots to the info map
+ *
+ * Slots are only used during solving, reportBug, printSS and stats read the info map
+ */
+void PSTA::flushInfoSlots() {
+    // slots referring to a symstate held by another slot, and distinct symstates
+    u32_t sharedNum = 0;
+    Set<const SymState *> uniqueStates;
+    for (const auto &item: *getICFGWrapper()) {
+        for (const auto &e: item.second->getOutEdges()) {
+            for (const auto &slot: e->_infoSlots) {
+                if (slot.isNullSymState()) continue;
+                if (slot.isShared()) sharedNum++;
+                uniqueStates.insert(slot.getStatePtr());
+            }
+        }
+    }
+    _stat->recordExeStateSharing(sharedNum, uniqueStates.size());
+    for (const auto &item: *getICFGWrapper()) {
+        for (const auto &e: item.second->getOutEdges()) {
+            if (e->_infoSlots.empty()) continue;
+            for (u32_t i = 0; i < _typeStates.size(); ++i) {
+                for (u32_t j = 0; j < _typeStates.size(); ++j) {
+                    SharedSymState &slot = e->_infoSlots[i * _typeStates.size() + j];
+                    if (slot.isNullSymState()) continue;
+                    _infoMap[std::make_pair(e, _typeStates[i])][_typeStates[j]] = slot.release();
+                }
+            }
+            std::vector<SharedSymState>().swap(e->_infoSlots);
+        }
+    }
 }
 
 /*!
@@ -286,6 +490,7 @@ void PSTA::processCallNodeIso(const CallICFGNode *callBlockNode, WLItem &curItem
 void PSTA::processExitNode(WLItem &curItem) {
     SymState symState = SVFUtil::move(getSymStateIn(curItem));
     nonBranchFlowFun(curItem.getICFGNodeWrapper(), symState);
+    if (PSAOptions::LiveProjection()) projectDeadVars(curItem.getICFGNodeWrapper(), symState);
     if (addToSummary(curItem.getICFGNodeWrapper(), curItem.getTypeState(), symState)) {
         std::vector<const ICFGNodeWrapper *> retNodes;
         returnSites(curItem.getICFGNodeWrapper(), retNodes);
@@ -295,6 +500,10 @@ void PSTA::processExitNode(WLItem &curItem) {
                     for (const auto &callerAs: getFSMParser()->getAbsStates()) {
                         if (!getInfo(inEdge, callerAs, formalInAs).isNullSymState()) {
                             if (hasSummary(fn(curItem.getICFGNodeWrapper()), formalInAs)) {
+                                if (!isSummaryDelta(curItem, formalInAs)) {
+                                    _stat->incDeltaSkippedPushNum();
+                                    continue;
+                                }
                                 _workList.push(WLItem(callSite(retSite), callerAs, formalInAs));
                             }
                         }
@@ -324,6 +533,10 @@ void PSTA::processExitNodeIso(WLItem &curItem) {
                     for (const auto &callerAs: getFSMParser()->getAbsStates()) {
                         if (!getInfo(inEdge, callerAs, formalInAs).isNullSymState()) {
                             if (hasSummary(fn(curItem.getICFGNodeWrapper()), formalInAs)) {
+                                if (!isSummaryDelta(curItem, formalInAs)) {
+                                    _stat->incDeltaSkippedPushNum();
+                                    continue;
+                                }
                                 _workList.push(WLItem(callSite(retSite), callerAs, formalInAs));
                             }
                         }
@@ -344,6 +557,10 @@ void PSTA::processBranchNode(WLItem &wlItem) {
     for (const auto &edge: wlItem.getICFGNodeWrapper()->getOutEdges()) {
         if (const IntraCFGEdge *intraCfgEdge = SVFUtil::dyn_cast<IntraCFGEdge>(edge->getICFGEdge())) {
             if (intraCfgEdge->getCondition()) {
+                if (!inSnkDirectedMask(edge->getDstNode())) {
+                    _stat->incPrunedPropagationNum();
+                    continue;
+                }
                 SymState symState = SVFUtil::move(getSymStateIn(wlItem));
                 PC_TYPE brCond = evalBranchCond(intraCfgEdge);
                 branchFlowFun(symState, intraCfgEdge, brCond);
@@ -364,15 +581,92 @@ void PSTA::processBranchNode(WLItem &wlItem) {
  * @param wlItem
  */
 void PSTA::processOtherNode(WLItem &wlItem) {
-    SymState symState = SVFUtil::move(getSymStateIn(wlItem));
-    nonBranchFlowFun(wlItem.getICFGNodeWrapper(), symState);
+    // in slot mode the state is a copy-on-write handle, see getSharedSymStateIn
+    SymState localSymState;
+    SharedSymState sharedSymState;
+    if (PSAOptions::InfoSlots())
+        sharedSymState = getSharedSymStateIn(wlItem);
+    else
+        localSymState = SVFUtil::move(getSymStateIn(wlItem));
+    bool projectsDeadVars = false;
+    if (PSAOptions::LiveProjection()) {
+        for (const auto &outEdge: getOutTEdges(nextNodeToAdd(wlItem.getICFGNodeWrapper()))) {
+            if (isMergeNode(outEdge->getDstNode())) {
+                projectsDeadVars = true;
+                break;
+            }
+        }
+    }
+    // a node leaving the state unchanged passes the in-edge state on without copying it
+    if (!PSAOptions::InfoSlots() || projectsDeadVars || hasNonBranchEffect(wlItem.getICFGNodeWrapper())) {
+        SymState &symState = PSAOptions::InfoSlots() ? sharedSymState.mut() : localSymState;
+        nonBranchFlowFun(wlItem.getICFGNodeWrapper(), symState);
+        if (projectsDeadVars) projectDeadVars(wlItem.getICFGNodeWrapper(), symState);
+    }
+    const SymState &symStateOut = PSAOptions::InfoSlots() ? sharedSymState.get() : localSymState;
+    // error state is already recorded as a finding, the bug is determined
+    if (PSAOptions::EagerError() && symStateOut.getAbstractState() == getFSMParser()->getErrAbsState())
+        return;
     for (const auto &outEdge: getOutTEdges(nextNodeToAdd(wlItem.getICFGNodeWrapper()))) {
-        if (addInfo(outEdge, wlItem.getTypeState(), symState)) {
-            _workList.push(WLItem(outEdge->getDstNode(), wlItem.getTypeState(), symState.getAbstractState()));
+        if (!inSnkDirectedMask(outEdge->getDstNode())) {
+            _stat->incPrunedPropagationNum();
+            continue;
+        }
+        bool changed = PSAOptions::InfoSlots() ? addInfo(outEdge, wlItem.getTypeState(), sharedSymState)
+                                               : addInfo(outEdge, wlItem.getTypeState(), localSymState);
+        if (changed) {
+            _workList.push(WLItem(outEdge->getDstNode(), wlItem.getTypeState(), symStateOut.getAbstractState()));
         }
     }
 }
 
+/*!
+ * Delta of the joined in-state of a merge node
+ *
+ * Infos on edges only grow, so does the joined in-state of a merge node. If none of the infos
+ * it joins changed since the node was last processed, e.g., a loop back edge brings nothing
+ * new to the loop head, the flow functions would only reproduce the infos on the out edges
+ * and exit nodes would reproduce the summary. Changes are read from the stamps addInfo leaves
+ * on the in edges, so the in-state is neither joined nor kept here. Call nodes are always
+ * processed since they also apply callee summaries, which may have changed in the meantime.
+ * @param curItem
+ * @return false if the merge node has nothing new to propagate
+ */
+bool PSTA::hasMergeDelta(WLItem &curItem) {
+    const ICFGNodeWrapper *node = curItem.getICFGNodeWrapper();
+    u32_t &lastStamp = _mergeStamps[std::make_pair(node, curItem.getTypeState())][curItem.getIndexTypeState()];
+    u32_t index = getInfoIndex(curItem.getTypeState(), curItem.getIndexTypeState());
+    bool changed = false;
+    for (const auto &edge: node->getInEdges()) {
+        if (edge->getICFGEdge()->isIntraCFGEdge() && !edge->_infoStamps.empty() &&
+            edge->_infoStamps[index] > lastStamp) {
+            changed = true;
+            break;
+        }
+    }
+    if (!changed) return false;
+    lastStamp = _infoStamp;
+    return true;
+}
+
+/*!
+ * Drop the top-level vars that are defined in the function of node and dead after it
+ *
+ * Applied before joining at merge nodes and before building summaries at function exits,
+ * so joins and summaries only compare live vars
+ * @param node
+ * @param symState
+ */
+void PSTA::projectDeadVars(const ICFGNodeWrapper *node, SymState &symState) {
+    if (symState.isNullSymState() || !fn(node)) return;
+    ConsExeState &es = symState.getExecutionState();
+    _stat->addLiveProjVarNum(es.getVarToVal().size() + es.getVarToAddrs().size());
+    // a super-node ends at its last member
+    const ICFGNode *lastNode = node->_blockMembers.empty() ? node->getICFGNode() : node->_blockMembers.back();
+    u32_t droppedNum = projectVars(es, _varLiveness.getFunDefs(fn(node)), _varLiveness.getLiveOut(lastNode));
+    _stat->addLiveDroppedVarNum(droppedNum);
+}
+
 /*!
  * Get the symstates from in edges
  * @param curItem
@@ -389,6 +683,25 @@ SymState PSTA::getSymStateIn(WLItem &curItem) {
     }
 }
 
+/*!
+ * Get the symstate from in edges as a copy-on-write handle (-info-slots)
+ *
+ * A node with a single in edge takes a reference to the state in the slot of the edge,
+ * the state is only copied when the node writes to it
+ * @param curItem
+ */
+SharedSymState PSTA::getSharedSymStateIn(WLItem &curItem) {
+    if (!isMergeNode(curItem.getICFGNodeWrapper())) {
+        assert(!curItem.getICFGNodeWrapper()->getInEdges().empty() && "in edge empty?");
+        const ICFGEdgeWrapper *inEdge = *curItem.getICFGNodeWrapper()->getInEdges().begin();
+        if (!inEdge->_infoSlots.empty()) {
+            const SharedSymState &slot = getInfoSlot(inEdge, curItem.getTypeState(), curItem.getIndexTypeState());
+            if (!slot.isNullSymState()) return slot;
+        }
+    }
+    return SharedSymState(getSymStateIn(curItem));
+}
+
 void PSTA::printSS() {
     outs() << "------------------\n";
     outs() << "SVFGNode Node: " << _curEvalSVFGNode->getValue()->toString() << "\n";
@@ -8,6 +8,7 @@
 #include "Slicing/GraphSparsificator.h"
 #include "PSTA/PSTABase.h"
 #include "PSTA/BTPExtractor.h"
+#include "PSTA/VarLiveness.h"
 
 
 namespace SVF {
@@ -25,8 +26,11 @@ class PSTA: public PSTABase {
 public:
     typedef std::pair<const ICFGEdgeWrapper *, TypeState> InfoKey; ///< a pair of ICFG edge and abstract state
     typedef Map<InfoKey, AbsToSymState> InfoMap;
-    typedef FIFOWorkList<WLItem> WorkList;                                   ///< worklist for ESP-ICFG
+    typedef DedupWorkList<WLItem> WorkList;                                  ///< worklist for ESP-ICFG
     typedef PIExtractor::SrcToNodeIDSetMap SrcToNodeIDSetMap;
+    typedef std::pair<const ICFGNodeWrapper *, TypeState> MergeKey; ///< a pair of merge node and abstract state
+    typedef Map<TypeState, u32_t> AbsToStamp;
+    typedef Map<MergeKey, AbsToStamp> MergeStampMap;
 
 
 protected:
@@ -35,6 +39,13 @@ protected:
     PSAStat *_stat;
     WorkList _workList;
     SrcToNodeIDSetMap _srcToESPBranch;
+    NodeBS _srcReachableNodes;            ///< wrapper nodes graph-reachable from the current src
+    NodeBS _snkDirectedMask;              ///< wrapper nodes that can reach a snk or program exit (-snk-directed)
+    std::vector<TypeState> _typeStates;   ///< interned typestates, the position is the typestate id
+    std::vector<u32_t> _typeStateIds;     ///< typestate (enum value) -> its position in _typeStates
+    VarLiveness _varLiveness;             ///< liveness of top-level vars, kept for all srcs (-live-proj)
+    MergeStampMap _mergeStamps;           ///< info stamp each merge node was last processed at (-delta-prop)
+    u32_t _infoStamp{0};                  ///< bumped on each info change (-delta-prop)
 public:
 
     /// Constructor
@@ -57,6 +68,45 @@ public:
     /// Main algorithm
     virtual void solve();
 
+    /// Phase one of the two-phase mode: path-insensitive typestate propagation on the compacted graph
+    virtual bool isSafeByTypestate(SVFModule *module);
+
+    /// Release the Z3 context, re-materialize branch conditions under the new one
+    virtual void recycleZ3Context();
+
+    /// Graph-reachability index of the current src over the compacted ICFGWrapper
+    //{%
+    void buildSrcReachability();
+
+    /// Whether node is graph-reachable from the current src (O(1))
+    inline bool isGraphReachableFromSrc(const ICFGNodeWrapper *node) const {
+        return _srcReachableNodes.test(node->getId());
+    }
+    //%}
+
+    /// Sink-directed pruning
+    //{%
+    /// Backward-reachability mask from the snks and program exits of the current src
+    void buildSnkDirectedMask();
+
+    /// Whether propagating into node may still matter
+    inline bool inSnkDirectedMask(const ICFGNodeWrapper *node) const {
+        return !PSAOptions::SnkDirected() || _snkDirectedMask.test(node->getId());
+    }
+    //%}
+
+    /// Drop top-level vars of the enclosing function that are dead after node (-live-proj)
+    void projectDeadVars(const ICFGNodeWrapper *node, SymState &symState);
+
+    /// Whether the joined in-state of merge node item curItem grew since the node was last processed (-delta-prop)
+    bool hasMergeDelta(WLItem &curItem);
+
+    /// Whether callsites entering with formalInAs consume the summary changed by exit item curItem
+    /// (-delta-prop), the changed summary is keyed by the typestate curItem entered the function with
+    inline bool isSummaryDelta(const WLItem &curItem, const TypeState &formalInAs) const {
+        return !PSAOptions::DeltaProp() || formalInAs == curItem.getTypeState();
+    }
+
     /// Process node
     //{%
     /// Process Call Node
@@ -169,12 +219,63 @@ public:
     inline void nonBranchFlowFun(const ICFGNodeWrapper *icfgNodeWrapper, SymState &symState) {
         _symStateMgr.setSymState(&symState);
         _symStateMgr.nonBranchFlowFun(icfgNodeWrapper->getICFGNode(), _curEvalSVFGNode);
+        // the rest of a super-node in one step (-block-wrapper)
+        for (const auto &member: icfgNodeWrapper->_blockMembers)
+            _symStateMgr.nonBranchFlowFun(member, _curEvalSVFGNode);
+    }
+
+    /// Whether nonBranchFlowFun may write to the symstate at icfgNodeWrapper
+    inline bool hasNonBranchEffect(const ICFGNodeWrapper *icfgNodeWrapper) const {
+        if (_symStateMgr.hasNonBranchEffect(icfgNodeWrapper->getICFGNode())) return true;
+        for (const auto &member: icfgNodeWrapper->_blockMembers) {
+            if (_symStateMgr.hasNonBranchEffect(member)) return true;
+        }
+        return false;
     }
     //%}
 
 
-    inline SymState &
+    /// Per-edge info slots (-info-slots)
+    //{%
+    /// Id of an interned typestate
+    inline u32_t getTypeStateId(const TypeState &absState) const {
+        u32_t value = static_cast<u32_t>(absState);
+        assert(value < _typeStateIds.size() && _typeStateIds[value] != UINT32_MAX && "typestate not interned?");
+        return _typeStateIds[value];
+    }
+
+    /// Position of (absState, indexAbsState) in the slots and stamps of an edge
+    inline u32_t getInfoIndex(const TypeState &absState, const TypeState &indexAbsState) const {
+        return getTypeStateId(absState) * _typeStates.size() + getTypeStateId(indexAbsState);
+    }
+
+    /// Info slot of edge e, slots are allocated on the first access
+    inline SharedSymState &
+    getInfoSlot(const ICFGEdgeWrapper *e, const TypeState &absState, const TypeState &indexAbsState) {
+        std::vector<SharedSymState> &slots = const_cast<ICFGEdgeWrapper *>(e)->_infoSlots;
+        if (slots.empty()) slots.resize(_typeStates.size() * _typeStates.size());
+        return slots[getInfoIndex(absState, indexAbsState)];
+    }
+
+    /// Stamp a change of the info of edge e (-delta-prop)
+    inline void stampInfo(const ICFGEdgeWrapper *e, const TypeState &absState, const TypeState &indexAbsState) {
+        if (!PSAOptions::DeltaProp()) return;
+        std::vector<u32_t> &stamps = const_cast<ICFGEdgeWrapper *>(e)->_infoStamps;
+        if (stamps.empty()) stamps.resize(_typeStates.size() * _typeStates.size(), 0);
+        stamps[getInfoIndex(absState, indexAbsState)] = ++_infoStamp;
+    }
+
+    /// Move the infos in slots to the info map, which is read by reportBug and stats
+    void flushInfoSlots();
+    //%}
+
+    inline const SymState &
     getInfo(const ICFGEdgeWrapper *e, const TypeState &absState, const TypeState &indexAbsState) {
+        if (PSAOptions::InfoSlots()) {
+            if (e->_infoSlots.empty()) return *_emptySymState;
+            const SharedSymState &slot = getInfoSlot(e, absState, indexAbsState);
+            return slot.isNullSymState() ? *_emptySymState : slot.get();
+        }
         InfoKey infoKey = std::make_pair(e, absState);
         auto it = _infoMap.find(infoKey);
         if (it == _infoMap.end())
@@ -191,12 +292,16 @@ public:
 
     inline bool addInfo(const ICFGEdgeWrapper *e, const TypeState &absState, SymState symState) {
         if (symState.isNullSymState()) return false;
+        if (PSAOptions::InfoSlots())
+            return addInfo(e, absState, SharedSymState(SVFUtil::move(symState)));
+        TypeState indexAbsState = symState.getAbstractState();
         InfoKey infoKey = std::make_pair(e, absState);
         auto it = _infoMap.find(infoKey);
         if (it != _infoMap.end()) {
-            auto absIdxIt = it->second.find(symState.getAbstractState());
+            auto absIdxIt = it->second.find(indexAbsState);
             if (absIdxIt == it->second.end()) {
-                it->second[symState.getAbstractState()] = SVFUtil::move(symState);
+                it->second[indexAbsState] = SVFUtil::move(symState);
+                stampInfo(e, absState, indexAbsState);
                 return true;
             } else {
                 SymStates symStates{absIdxIt->second}; // original symstate
@@ -204,15 +309,39 @@ public:
                 SymState symStateOut;
                 if (groupingAbsStates(symStates, symStateOut)) { // symstate changed
                     absIdxIt->second = SVFUtil::move(symStateOut);
+                    stampInfo(e, absState, indexAbsState);
                     return true;
                 } else {
                     return false;
                 }
             }
         } else {
-            _infoMap[infoKey][symState.getAbstractState()] = SVFUtil::move(symState);
+            _infoMap[infoKey][indexAbsState] = SVFUtil::move(symState);
+            stampInfo(e, absState, indexAbsState);
+            return true;
+        }
+    }
+
+    /// Add a shared symstate to a slot, an empty slot takes a reference instead of a copy (-info-slots)
+    inline bool addInfo(const ICFGEdgeWrapper *e, const TypeState &absState, const SharedSymState &symState) {
+        if (symState.isNullSymState()) return false;
+        TypeState indexAbsState = symState.get().getAbstractState();
+        SharedSymState &slot = getInfoSlot(e, absState, indexAbsState);
+        if (slot.isNullSymState()) {
+            slot = symState;
+            stampInfo(e, absState, indexAbsState);
             return true;
         }
+        SymStates symStates{slot.get()}; // original symstate
+        symStates.push_back(symState.get());
+        SymState symStateOut;
+        if (groupingAbsStates(symStates, symStateOut)) { // symstate changed
+            slot = SharedSymState(SVFUtil::move(symStateOut));
+            stampInfo(e, absState, indexAbsState);
+            return true;
+        } else {
+            return false;
+        }
     }
 
     /// Maps a node to the name of its enclosing function
@@ -322,6 +451,9 @@ public:
     /// Get the symstates from in edges, merge states when multiple in edges
     SymState getSymStateIn(WLItem &curItem);
 
+    /// Get the symstate from in edges, sharing the state of a single in edge (-info-slots)
+    SharedSymState getSharedSymStateIn(WLItem &curItem);
+
     /// Initialize info and summary map
     virtual void initMap(SVFModule *module);
 
@@ -85,15 +85,15 @@ bool ExeStateManager::handleBranch(const IntraCFGEdge *edge) {
         return true;
     } else {
         const Z3Expr &curPc = _es->getBrCond();
-        Z3Expr nPc = (curPc && condition.getExpr()).simplify();
+        Z3Expr nPc = conjoinBrCond(curPc, condition.getExpr());
         if (nPc.getExpr().is_true()) return true;
         if (nPc.getExpr().is_false()) return false;
-        if (Z3Expr::getExprSize(nPc) > PSAOptions::MaxSymbolSize()) {
+        if (BranchAllocator::exceedsExprSize(nPc, PSAOptions::MaxSymbolSize())) {
             nPc = Z3Expr::getTrueCond();
             _es->setBrCond(nPc);
             return true;
         }
-        z3::check_result res = ConsExeState::solverCheck(nPc);
+        z3::check_result res = BranchAllocator::condCheck(nPc);
         if (res == z3::unsat) {
             return false;
         } else {
@@ -106,6 +106,73 @@ bool ExeStateManager::handleBranch(const IntraCFGEdge *edge) {
     }
 }
 
+/*!
+ * Whether lhs is the negation of rhs (syntactically)
+ */
+static inline bool isNegationOf(const z3::expr &lhs, const z3::expr &rhs) {
+    return lhs.is_app() && lhs.decl().decl_kind() == Z3_OP_NOT && lhs.arg(0).id() == rhs.id();
+}
+
+/*!
+ * Conjoin a branch condition to a path condition
+ *
+ * Trivially true/false conjunctions (a constant operand, cond already a conjunct of curPc,
+ * or cond contradicting a conjunct) are recognized structurally without invoking Z3,
+ * others go through the simplification cache
+ * @param curPc simplified path condition
+ * @param cond simplified branch condition
+ * @return simplified conjunction
+ */
+Z3Expr ExeStateManager::conjoinBrCond(const Z3Expr &curPc, const Z3Expr &cond) {
+    const z3::expr &pcExpr = curPc.getExpr();
+    const z3::expr &condExpr = cond.getExpr();
+    if (pcExpr.is_false() || condExpr.is_false()) {
+        ++_simplifyFastPaths;
+        return Z3Expr::getFalseCond();
+    }
+    if (pcExpr.is_true()) {
+        ++_simplifyFastPaths;
+        return cond;
+    }
+    if (condExpr.is_true()) {
+        ++_simplifyFastPaths;
+        return curPc;
+    }
+    bool isAnd = pcExpr.is_app() && pcExpr.decl().decl_kind() == Z3_OP_AND;
+    u32_t conjunctNum = isAnd ? pcExpr.num_args() : 1;
+    for (u32_t i = 0; i < conjunctNum; ++i) {
+        const z3::expr conjunct = isAnd ? pcExpr.arg(i) : pcExpr;
+        if (conjunct.id() == condExpr.id()) {
+            ++_simplifyFastPaths;
+            return curPc;
+        }
+        if (isNegationOf(conjunct, condExpr) || isNegationOf(condExpr, conjunct)) {
+            ++_simplifyFastPaths;
+            return Z3Expr::getFalseCond();
+        }
+    }
+    return simplify(curPc && cond);
+}
+
+/*!
+ * Simplify an expression, memoized by AST id
+ * @param expr
+ * @return
+ */
+Z3Expr ExeStateManager::simplify(const Z3Expr &expr) {
+    auto it = _simplifyCache.find(expr.id());
+    if (it != _simplifyCache.end()) {
+        ++_simplifyHits;
+        return it->second.second;
+    }
+    ++_simplifyMisses;
+    Z3Expr res = expr.simplify();
+    if (PSAOptions::MaxSimplifyCache() != 0 && _simplifyCache.size() >= PSAOptions::MaxSimplifyCache())
+        _simplifyCache.clear();
+    _simplifyCache.emplace(expr.id(), std::make_pair(expr, res));
+    return res;
+}
+
 ConsExeState ExeStateManager::nullExeState() {
     return ConsExeState::nullExeState();
 }
@@ -156,6 +223,20 @@ void ExeStateManager::collectGlobalStore() {
     }
 }
 
+/*!
+ * Drop the global execution states
+ *
+ * Global store and global ptrs are kept since they are ID-based,
+ * the states are rebuilt lazily (handleGlobalNode/getOrBuildGlobalExeState)
+ */
+void ExeStateManager::releaseZ3State() {
+    delete _globalES;
+    _globalES = nullptr;
+    delete ConsExeState::globalConsES;
+    ConsExeState::globalConsES = nullptr;
+    _simplifyCache.clear();
+}
+
 void ExeStateManager::collectFuncToGlobalPtrs(ICFG *icfg) {
     getOrBuildGlobalExeState(icfg->getGlobalICFGNode());
     collectGlobalStore();
@@ -182,7 +263,7 @@ void ExeStateManager::collectFuncToGlobalPtrs(ICFG *icfg) {
 bool SymStateManager::branchFlowFun(const IntraCFGEdge *intraEdge, PC_TYPE pcType) {
     if (PSAOptions::EnableReport()) {
         Z3Expr branchCond = BranchAllocator::getCondAllocator()->getBranchCond(intraEdge);
-        _symState->setBranchCondition((_symState->getBranchCondition() && branchCond).simplify());
+        _symState->setBranchCondition(BranchAllocator::condAnd(_symState->getBranchCondition(), branchCond));
     }
     if (pcType == PC_TYPE::UNK_PC) {
         // Update execution state according to branch condition
@@ -199,6 +280,7 @@ bool SymStateManager::branchFlowFun(const IntraCFGEdge *intraEdge, PC_TYPE pcTyp
  * @param svfgNode
  */
 void SymStateManager::nonBranchFlowFun(const ICFGNode *icfgNode, const SVFGNode *svfgNode) {
+    bool wasErr = _symState->getAbstractState() == getFSMParser()->getErrAbsState();
     // Update execution state according to ICFG node
     getExeStateMgr()->setEs(&_symState->getExecutionState());
     getExeStateMgr()->handleNonBranch(icfgNode);
@@ -207,6 +289,44 @@ void SymStateManager::nonBranchFlowFun(const ICFGNode *icfgNode, const SVFGNode
     } else {
         onTheFlyNonBranchFlowFun(icfgNode, svfgNode);
     }
+    // The bug is determined at the error transition
+    if (PSAOptions::EagerError() && !wasErr && _symState->getAbstractState() == getFSMParser()->getErrAbsState())
+        recordErrFinding(icfgNode);
+}
+
+/*!
+ * Whether nonBranchFlowFun may write to the symstate at icfgNode
+ *
+ * Conservative: nodes without a transition and without statements handled by
+ * handleNonBranch leave the symstate unchanged
+ * @param icfgNode
+ */
+bool SymStateManager::hasNonBranchEffect(const ICFGNode *icfgNode) const {
+    if (SVFUtil::isa<CallICFGNode>(icfgNode) || icfgNode == _curEvalICFGNode) return true;
+    if (getAbsTransitionHandler()->getICFGAbsTransferMap().count(icfgNode)) return true;
+    if (getAbsTransitionHandler()->isMainRetNode(icfgNode)) return true;
+    if (!PSAOptions::PathSensitive()) return false;
+    for (const SVFStmt *stmt: icfgNode->getSVFStmts()) {
+        if (!SVFUtil::isa<UnaryOPStmt>(stmt) && !SVFUtil::isa<BranchStmt>(stmt)) return true;
+    }
+    return false;
+}
+
+/*!
+ * Join the current symstate into the witness of the error at icfgNode
+ *
+ * One witness per (node, typestate), joined like the states at a merge point
+ * @param icfgNode
+ */
+void SymStateManager::recordErrFinding(const ICFGNode *icfgNode) {
+    ErrFindingKey key = std::make_pair(icfgNode, _symState->getAbstractState());
+    auto it = _errFindings.find(key);
+    if (it == _errFindings.end()) {
+        _errFindings.emplace(key, *_symState);
+        return;
+    }
+    SymStates witnesses{SVFUtil::move(it->second), *_symState};
+    groupingAbsStates(witnesses, it->second);
 }
 
 void SymStateManager::preNonBranchFlowFun(const SVF::ICFGNode *icfgNode, const SVF::SVFGNode *svfgNode) {
@@ -285,8 +405,7 @@ void SymStateManager::onTheFlyNonBranchFlowFun(const SVF::ICFGNode *icfgNode, co
             }
         } // end CK_USE
         if (_checkerTypes.find(FSMParser::CK_RET) != _checkerTypes.end()) {
-            if (intraICFGNode->getFun() == getAbsTransitionHandler()->getMainFunc() &&
-                intraICFGNode->getInst()->isRetInst()) {
+            if (getAbsTransitionHandler()->isMainRetNode(intraICFGNode)) {
                 const TypeState &tgtAbsState = getAbsTransitionHandler()->absStateTransition(
                         _symState->getAbstractState(), FSMAction::CK_RET);
                 if (tgtAbsState != _symState->getAbstractState()) {
@@ -332,7 +451,7 @@ bool SymStateManager::groupingAbsStates(const SymStates &symStates, SymState &sy
                 for (const auto &n: it.getKeyNodesSet()) {
                     keyNodesSet.insert(std::move(const_cast<KeyNodes &>(n)));
                 }
-                brc = (brc || it.getBranchCondition()).simplify();
+                brc = BranchAllocator::condOr(brc, it.getBranchCondition());
             }
         }
     }
@@ -387,6 +506,9 @@ PSTABase::~PSTABase() {
     ExeStateManager::releaseExeStateManager();
     delete _emptySymState;
     _emptySymState = nullptr;
+    // the SVFG and the branch conditions must go before the PAG and the Z3 context they refer to
+    FSMHandler::releaseAbsTransitionHandler();
+    BranchAllocator::releaseCondAllocator();
     AndersenWaveDiff::releaseAndersenWaveDiff();
     SVFIR::releaseSVFIR();
     Z3Expr::releaseContext();
@@ -477,6 +599,24 @@ void PSTABase::initialize(SVFModule *module) {
     getExeStateMgr()->collectGlobalStore();
 }
 
+/*!
+ * Recycle the Z3 context
+ *
+ * Z3 never trims its AST tables, so every term created for previous srcs is
+ * kept alive by the global context. Drop every Z3 term outliving a src,
+ * re-create the context (lazily, by Z3Expr::getContext) and rebuild the global state.
+ */
+void PSTABase::recycleZ3Context() {
+    _infoMap.clear();
+    _summaryMap.clear();
+    delete _emptySymState;
+    _emptySymState = nullptr;
+    getExeStateMgr()->releaseZ3State();
+    Z3Expr::releaseContext();
+    _emptySymState = new SymState();
+    getExeStateMgr()->handleGlobalNode();
+}
+
 void PSTABase::initHandler(SVFModule *module) {
     ICFG *icfg = PAG::getPAG()->getICFG();
 }
@@ -958,11 +1098,53 @@ void PSTABase::buildSummary(ConsExeState &es, ConsExeState &summary, const SVFVa
     }
 }
 
+/*!
+ * Project dead top-level vars out of es
+ *
+ * Memory and branch condition are kept as is
+ * @param es
+ * @param droppable vars that may be dropped (e.g., defined in the current function)
+ * @param live vars still used afterwards
+ * @return number of dropped vars
+ */
+u32_t PSTABase::projectVars(ConsExeState &es, const NodeBS &droppable, const NodeBS &live) {
+    auto isDead = [&](u32_t id) {
+        return droppable.test(id) && !live.test(id);
+    };
+    u32_t deadNum = 0;
+    for (const auto &item: es.getVarToVal()) {
+        if (isDead(item.first)) deadNum++;
+    }
+    for (const auto &item: es.getVarToAddrs()) {
+        if (isDead(item.first)) deadNum++;
+    }
+    if (deadNum == 0) return 0;
+
+    ConsExeState newEs(ConsExeState::initExeState());
+    for (const auto &item: es.getVarToVal()) {
+        if (!isDead(item.first)) newEs[item.first] = es[item.first];
+    }
+    for (const auto &item: es.getVarToAddrs()) {
+        if (!isDead(item.first)) newEs.getAddrs(item.first) = es.getAddrs(item.first);
+    }
+    for (const auto &item: es.getLocToVal()) {
+        newEs.store(SingleAbsValue(getVirtualMemAddress(item.first)),
+                    es.load(SingleAbsValue(getVirtualMemAddress(item.first))));
+    }
+    for (const auto &item: es.getLocToAddrs()) {
+        newEs.storeAddrs(getVirtualMemAddress(item.first), es.loadAddrs(getVirtualMemAddress(item.first)));
+    }
+    newEs.setBrCond(es.getBrCond());
+    es = SVFUtil::move(newEs);
+    return deadNum;
+}
+
 bool PSTABase::isSrcSnkReachable(const ConsExeState &src, const ConsExeState &snk) {
     const Z3Expr &snkBrCond = snk.getBrCond();
     const Z3Expr &srcBrCond = src.getBrCond();
     const Z3Expr &jointBrCond = (srcBrCond && snkBrCond).simplify();
     if (jointBrCond.getExpr().is_false()) return false;
-    if (jointBrCond.getExpr().is_true() || Z3Expr::getExprSize(jointBrCond) > PSAOptions::MaxSymbolSize()) return true;
-    return ConsExeState::solverCheck(jointBrCond) != z3::unsat;
+    if (jointBrCond.getExpr().is_true() || BranchAllocator::exceedsExprSize(jointBrCond, PSAOptions::MaxSymbolSize()))
+        return true;
+    return BranchAllocator::condCheck(jointBrCond) != z3::unsat;
 }
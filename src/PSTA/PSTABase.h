@@ -7,6 +7,7 @@
 
 #include "Graphs/SVFG.h"
 #include "Util/WorkList.h"
+#include "PSTA/DedupWorkList.h"
 #include "WPA/Andersen.h"
 #include "SVF-LLVM/LLVMUtil.h"
 #include "PSTA/FSMHandler.h"
@@ -100,6 +101,15 @@ private:
     Set<u32_t> _globalStore;
     Map<const SVFFunction *, OrderedSet<u32_t>> _funcToGlobalPtrs;
 
+    /// Path condition simplification cache
+    //{%
+    typedef std::pair<Z3Expr, Z3Expr> SimplifyItem; ///< (expr, simplified expr), the expr pins the AST id
+    Map<u32_t, SimplifyItem> _simplifyCache;        ///< AST id -> simplification
+    u32_t _simplifyHits{0};
+    u32_t _simplifyMisses{0};
+    u32_t _simplifyFastPaths{0};
+    //%}
+
     /// Constructor
     explicit ExeStateManager() {}
 
@@ -144,6 +154,30 @@ public:
 
     void collectGlobalStore();
 
+    /// Drop the global execution states, which hold Z3 terms (used when recycling the Z3 context)
+    void releaseZ3State();
+
+    /// Conjoin a branch condition to a path condition (structural fast path, then cached simplification)
+    Z3Expr conjoinBrCond(const Z3Expr &curPc, const Z3Expr &cond);
+
+    /// Simplify an expression through the cache
+    Z3Expr simplify(const Z3Expr &expr);
+
+    /// Simplification statistics
+    //{%
+    inline u32_t getSimplifyHitNum() const {
+        return _simplifyHits;
+    }
+
+    inline u32_t getSimplifyMissNum() const {
+        return _simplifyMisses;
+    }
+
+    inline u32_t getSimplifyFastPathNum() const {
+        return _simplifyFastPaths;
+    }
+    //%}
+
 }; // end class ExeStateManager
 
 class SymStateManager {
@@ -154,6 +188,8 @@ public:
     typedef SymState::KeyNodesSet KeyNodesSet;
     typedef SymState::KeyNodes KeyNodes;
     typedef SVFIR2ConsExeState::Addrs Addrs;
+    typedef std::pair<const ICFGNode *, TypeState> ErrFindingKey; ///< error node and its typestate
+    typedef Map<ErrFindingKey, SymState> ErrFindings; ///< (error node, typestate) -> joined witness (-eager-err)
 
     enum PC_TYPE {
         UNK_PC = 0,
@@ -168,6 +204,7 @@ private:
     SymState *_symState{};
     u32_t _src{0};
     s64_t _srcNum{0};
+    ErrFindings _errFindings;
 
 public:
 
@@ -197,6 +234,9 @@ public:
     /// Flow function for processing non-branch node
     void nonBranchFlowFun(const ICFGNode *icfgNode, const SVFGNode *svfgNode);
 
+    /// Whether the non-branch flow function may write to the symstate at icfgNode
+    bool hasNonBranchEffect(const ICFGNode *icfgNode) const;
+
     void preNonBranchFlowFun(const ICFGNode *icfgNode, const SVFGNode *svfgNode);
 
     void onTheFlyNonBranchFlowFun(const ICFGNode *icfgNode, const SVFGNode *svfgNode);
@@ -283,6 +323,25 @@ public:
     inline void setCheckerTypes(Set<FSMParser::CHECKER_TYPE> &checkerTypes) {
         _checkerTypes = checkerTypes;
     }
+
+    inline bool hasCheckerType(FSMParser::CHECKER_TYPE checkerType) const {
+        return _checkerTypes.find(checkerType) != _checkerTypes.end();
+    }
+
+    /// Bugs recorded at the error transition (-eager-err)
+    //{%
+    inline const ErrFindings &getErrFindings() const {
+        return _errFindings;
+    }
+
+    inline void clearErrFindings() {
+        _errFindings.clear();
+    }
+    //%}
+
+private:
+    /// Join the current symstate into the witness of the error at icfgNode
+    void recordErrFinding(const ICFGNode *icfgNode);
 }; // end class SymStateManager
 
 /*!
@@ -296,7 +355,7 @@ public:
     typedef PTACallGraph::FunctionSet FunctionSet;
     typedef SymStateManager::SymStates SymStates;
     typedef std::pair<const ICFGEdge *, TypeState> InfoKey; ///< a pair of ICFG edge and abstract state
-    typedef FIFOWorkList<ESPWLItem> WorkList;
+    typedef DedupWorkList<ESPWLItem> WorkList;
     typedef Map<TypeState, SymState> AbsToSymState;
     typedef Map<InfoKey, AbsToSymState> InfoMap;
     typedef Map<TypeState, SymStates> AbsStateToSymStatesMap;        ///< map abstract state to symbolic states
@@ -349,6 +408,9 @@ public:
     /// Main algorithm
     virtual void solve();
 
+    /// Release the Z3 context and re-materialize the Z3 terms still needed
+    virtual void recycleZ3Context();
+
     /// Process node
     //{%
     /// Process Call Node
@@ -767,6 +829,9 @@ public:
     static void buildSummary(ConsExeState &es, ConsExeState &summary, const SVFVar *formalRet,
                              Set<const FormalOUTSVFGNode *> &formalOuts);
 
+    /// Drop the vars in droppable but not in live, return the number of dropped vars
+    static u32_t projectVars(ConsExeState &es, const NodeBS &droppable, const NodeBS &live);
+
     /// Evaluate null like expression for source-sink related bug detection in SABER
     PC_TYPE evaluateTestNullLikeExpr(const BranchStmt *cmpInst, const IntraCFGEdge *edge);
 
@@ -0,0 +1,93 @@
+#include "PSTA/PathCondBDD.h"
+
+using namespace SVF;
+
+PathCondBDD::PathCondBDD() {
+    // terminals: var is meaningless, lo/hi point to themselves
+    _nodes.push_back({UINT32_MAX, FalseNode, FalseNode});
+    _nodes.push_back({UINT32_MAX, TrueNode, TrueNode});
+}
+
+/*!
+ * Allocate a fresh decision variable
+ * @return the positive literal of the variable
+ */
+PathCondBDD::BDDNode PathCondBDD::newVar() {
+    return mkNode(_varNum++, FalseNode, TrueNode);
+}
+
+PathCondBDD::BDDNode PathCondBDD::getVar(u32_t var) {
+    assert(var < _varNum && "var not allocated?");
+    return mkNode(var, FalseNode, TrueNode);
+}
+
+/*!
+ * Find or create node (var, lo, hi), keeping the diagram reduced
+ */
+PathCondBDD::BDDNode PathCondBDD::mkNode(u32_t var, BDDNode lo, BDDNode hi) {
+    if (lo == hi) return lo;
+    UniqueKey key = std::make_pair(var, std::make_pair(lo, hi));
+    auto it = _uniqueTable.find(key);
+    if (it != _uniqueTable.end()) return it->second;
+    BDDNode id = _nodes.size();
+    _nodes.push_back({var, lo, hi});
+    _uniqueTable.emplace(key, id);
+    return id;
+}
+
+PathCondBDD::BDDNode PathCondBDD::bddAnd(BDDNode lhs, BDDNode rhs) {
+    return apply(lhs, rhs, true);
+}
+
+PathCondBDD::BDDNode PathCondBDD::bddOr(BDDNode lhs, BDDNode rhs) {
+    return apply(lhs, rhs, false);
+}
+
+/*!
+ * Shannon expansion on the smallest top variable of lhs and rhs
+ */
+PathCondBDD::BDDNode PathCondBDD::apply(BDDNode lhs, BDDNode rhs, bool isAnd) {
+    // terminal cases
+    if (isAnd) {
+        if (lhs == FalseNode || rhs == FalseNode) return FalseNode;
+        if (lhs == TrueNode) return rhs;
+        if (rhs == TrueNode) return lhs;
+    } else {
+        if (lhs == TrueNode || rhs == TrueNode) return TrueNode;
+        if (lhs == FalseNode) return rhs;
+        if (rhs == FalseNode) return lhs;
+    }
+    if (lhs == rhs) return lhs;
+    // both operations are commutative
+    if (lhs > rhs) std::swap(lhs, rhs);
+    Map<OpKey, BDDNode> &cache = isAnd ? _andCache : _orCache;
+    OpKey key = std::make_pair(lhs, rhs);
+    auto it = cache.find(key);
+    if (it != cache.end()) return it->second;
+
+    u32_t lVar = topVar(lhs), rVar = topVar(rhs);
+    u32_t var = std::min(lVar, rVar);
+    BDDNode lLo = lVar == var ? _nodes[lhs].lo : lhs;
+    BDDNode lHi = lVar == var ? _nodes[lhs].hi : lhs;
+    BDDNode rLo = rVar == var ? _nodes[rhs].lo : rhs;
+    BDDNode rHi = rVar == var ? _nodes[rhs].hi : rhs;
+    BDDNode lo = apply(lLo, rLo, isAnd);
+    BDDNode hi = apply(lHi, rHi, isAnd);
+    BDDNode res = mkNode(var, lo, hi);
+    cache[key] = res;
+    return res;
+}
+
+PathCondBDD::BDDNode PathCondBDD::bddNeg(BDDNode node) {
+    if (node == FalseNode) return TrueNode;
+    if (node == TrueNode) return FalseNode;
+    auto it = _negCache.find(node);
+    if (it != _negCache.end()) return it->second;
+    u32_t var = _nodes[node].var;
+    BDDNode lo = bddNeg(_nodes[node].lo);
+    BDDNode hi = bddNeg(_nodes[node].hi);
+    BDDNode res = mkNode(var, lo, hi);
+    _negCache[node] = res;
+    _negCache[res] = node;
+    return res;
+}
@@ -0,0 +1,114 @@
+#ifndef PSA_PATHCONDBDD_H
+#define PSA_PATHCONDBDD_H
+
+#include "Util/SVFUtil.h"
+
+namespace SVF {
+
+/*!
+ * Reduced ordered binary decision diagram for branch path conditions
+ *
+ * Branch conditions allocated by BranchAllocator are pure propositional formulas
+ * over decision variables, so a canonical BDD gives constant time equality and
+ * satisfiability (a node is satisfiable iff it is not the false terminal).
+ * Variables are ordered by their allocation index.
+ */
+class PathCondBDD {
+public:
+    typedef u32_t BDDNode;
+
+    static const BDDNode FalseNode = 0;
+    static const BDDNode TrueNode = 1;
+
+private:
+    /// An internal node: if var then hi else lo
+    struct Node {
+        u32_t var;
+        BDDNode lo;
+        BDDNode hi;
+    };
+
+    typedef std::pair<BDDNode, BDDNode> OpKey;
+    typedef std::pair<u32_t, OpKey> UniqueKey;
+
+    std::vector<Node> _nodes;                  ///< node table, terminals at index 0 and 1
+    Map<UniqueKey, BDDNode> _uniqueTable;      ///< hash-consing of internal nodes
+    Map<OpKey, BDDNode> _andCache;             ///< memoized conjunctions
+    Map<OpKey, BDDNode> _orCache;              ///< memoized disjunctions
+    Map<BDDNode, BDDNode> _negCache;           ///< memoized negations
+    u32_t _varNum{0};
+
+public:
+    PathCondBDD();
+
+    /// Allocate a fresh decision variable and return its positive literal
+    BDDNode newVar();
+
+    /// Literal of an already allocated variable
+    BDDNode getVar(u32_t var);
+
+    /// Boolean operations
+    //{%
+    BDDNode bddAnd(BDDNode lhs, BDDNode rhs);
+
+    BDDNode bddOr(BDDNode lhs, BDDNode rhs);
+
+    BDDNode bddNeg(BDDNode node);
+    //%}
+
+    /// Node accessors
+    //{%
+    static inline bool isTerminal(BDDNode node) {
+        return node <= TrueNode;
+    }
+
+    inline u32_t getNodeVar(BDDNode node) const {
+        assert(!isTerminal(node) && "terminal has no var!");
+        return _nodes[node].var;
+    }
+
+    inline BDDNode getLo(BDDNode node) const {
+        assert(!isTerminal(node) && "terminal has no lo branch!");
+        return _nodes[node].lo;
+    }
+
+    inline BDDNode getHi(BDDNode node) const {
+        assert(!isTerminal(node) && "terminal has no hi branch!");
+        return _nodes[node].hi;
+    }
+    //%}
+
+    /// Statistics
+    //{%
+    inline u32_t getTotalNodeNum() const {
+        return _nodes.size() - 2;
+    }
+
+    inline u32_t getVarNum() const {
+        return _varNum;
+    }
+    //%}
+
+    /// Drop memoized operations (nodes stay valid)
+    inline void clearOpCaches() {
+        _andCache.clear();
+        _orCache.clear();
+        _negCache.clear();
+    }
+
+private:
+    /// Find or create the node (var, lo, hi)
+    BDDNode mkNode(u32_t var, BDDNode lo, BDDNode hi);
+
+    /// Top variable of node; terminals are ordered after every variable
+    inline u32_t topVar(BDDNode node) const {
+        return isTerminal(node) ? UINT32_MAX : _nodes[node].var;
+    }
+
+    /// Shannon apply for and/or
+    BDDNode apply(BDDNode lhs, BDDNode rhs, bool isAnd);
+
+}; // end class PathCondBDD
+} // end namespace SVF
+
+#endif //PSA_PATHCONDBDD_H
@@ -22,6 +22,8 @@ void SNKExtractor::initialize(SVFModule *svfModule) {
     }
     _mainEntry = getICFGWrapper()->getFunEntry(getAbsTransitionHandler()->getMainFunc());
     assert(_mainEntry && "no main function?");
+    // the solver only traverses from main entry
+    getICFGWrapper()->materializeReachable({_mainEntry}, true);
 }
 
 
@@ -100,12 +102,10 @@ void SNKExtractor::collectSnks() {
     ICFGNodeSet snkToRm;
     for (const auto &node: _snks) {
         const ICFGNodeWrapper *evalNode = icfgWrapper->getICFGNodeWrapper(node->getId());
-        if (PSAOptions::Wrapper())
-            evalNode = icfgWrapper->getICFGNodeWrapper(
-                    dyn_cast<CallICFGNode>(node)->getRetICFGNode()->getId());
-        else if (SVFUtil::isa<CallICFGNode>(evalNode->getICFGNode())) {
-            evalNode = icfgWrapper->getICFGNodeWrapper(
-                    dyn_cast<CallICFGNode>(node)->getRetICFGNode()->getId());
+        // states of a call snk are read on its ret node
+        if (const CallICFGNode *callNode = dyn_cast<CallICFGNode>(node)) {
+            if (PSAOptions::Wrapper() || evalNode)
+                evalNode = icfgWrapper->getICFGNodeWrapper(callNode->getRetICFGNode()->getId());
         }
         // snk not reachable
         if (!evalNode) {
@@ -22,7 +22,7 @@ public:
     typedef Map<const SVFFunction *, Set<const SVFBasicBlock *>> FunToExitBBsMap;  ///< map a function to all its basic blocks calling program exit
     typedef Map<SummaryKey, TypeStates> SummaryMap;
 
-    typedef FIFOWorkList<WLItem> WorkList;
+    typedef DedupWorkList<WLItem> WorkList;
 
     enum PC_TYPE {
         UNK_PC = 0,
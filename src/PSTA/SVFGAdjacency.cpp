@@ -0,0 +1,95 @@
+#include "PSTA/SVFGAdjacency.h"
+#include "PSTA/PSAOptions.h"
+#include <thread>
+
+using namespace SVF;
+using namespace SVFUtil;
+
+void SVF::forEachIDRange(u32_t nodeNum, u32_t threadNum, const std::function<void(NodeID, NodeID)> &f) {
+    threadNum = std::min(threadNum, nodeNum);
+    if (threadNum <= 1) {
+        f(0, nodeNum);
+        return;
+    }
+    u32_t chunk = (nodeNum + threadNum - 1) / threadNum;
+    std::vector<std::thread> threads;
+    for (NodeID begin = 0; begin < nodeNum; begin += chunk)
+        threads.emplace_back(f, begin, std::min(begin + chunk, nodeNum));
+    for (auto &thread: threads)
+        thread.join();
+}
+
+void SVFGAdjacency::init(const SVFG *svfg) {
+    clear();
+    _svfg = svfg;
+    for (const auto &item: *svfg)
+        _nodeNum = std::max(_nodeNum, item.first + 1);
+}
+
+/*!
+ * Edges keep the order of the SVFG edge sets, so traversals visit nodes as before
+ * @param csr
+ * @param in in edges (with their src nodes) or out edges (with their dst nodes)
+ */
+void SVFGAdjacency::buildEdges(EdgeCSR &csr, bool in) {
+    assert(_svfg && "svfg adjacency not initialized?");
+    const SVFG *svfg = _svfg;
+    csr.build(_nodeNum, PSAOptions::CSRThreads(), [svfg, in](NodeID id, std::vector<Edge> &edges) {
+        if (!svfg->hasGNode(id)) return;
+        const SVFGNode *node = svfg->getGNode(id);
+        if (in) {
+            for (const auto &edge: node->getInEdges())
+                edges.push_back(toEdge(edge, edge->getSrcNode()));
+        } else {
+            for (const auto &edge: node->getOutEdges())
+                edges.push_back(toEdge(edge, edge->getDstNode()));
+        }
+    });
+}
+
+/*!
+ * Only the entries of the nodes of the built svfg are packed
+ * @param jumps
+ * @param csr
+ */
+void SVFGAdjacency::packJumps(const JumpMap &jumps, NodeCSR &csr) {
+    assert(_svfg && "svfg adjacency not initialized?");
+    std::vector<const Set<const SVFGNode *> *> idToJumps(_nodeNum, nullptr);
+    for (const auto &item: jumps) {
+        NodeID id = item.first->getId();
+        if (id < _nodeNum && _svfg->hasGNode(id) && _svfg->getGNode(id) == item.first)
+            idToJumps[id] = &item.second;
+    }
+    csr.build(_nodeNum, PSAOptions::CSRThreads(), [&idToJumps](NodeID id, std::vector<const SVFGNode *> &nodes) {
+        if (idToJumps[id])
+            nodes.insert(nodes.end(), idToJumps[id]->begin(), idToJumps[id]->end());
+    });
+}
+
+SVFGAdjacency::Edge SVFGAdjacency::toEdge(const SVFGEdge *edge, const SVFGNode *node) {
+    Edge res;
+    res.node = node;
+    if (edge->isCallVFGEdge()) {
+        res.kind = CallEdge;
+        if (const CallDirSVFGEdge *callEdge = dyn_cast<CallDirSVFGEdge>(edge))
+            res.csId = callEdge->getCallSiteId();
+        else
+            res.csId = cast<CallIndSVFGEdge>(edge)->getCallSiteId();
+    } else if (edge->isRetVFGEdge()) {
+        res.kind = RetEdge;
+        if (const RetDirSVFGEdge *retEdge = dyn_cast<RetDirSVFGEdge>(edge))
+            res.csId = retEdge->getCallSiteId();
+        else
+            res.csId = cast<RetIndSVFGEdge>(edge)->getCallSiteId();
+    }
+    return res;
+}
+
+void SVFGAdjacency::clear() {
+    _svfg = nullptr;
+    _nodeNum = 0;
+    _inEdges.clear();
+    _outEdges.clear();
+    _outToIns.clear();
+    _inToOuts.clear();
+}
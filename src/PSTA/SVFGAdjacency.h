@@ -0,0 +1,205 @@
+#ifndef PSA_SVFGADJACENCY_H
+#define PSA_SVFGADJACENCY_H
+
+#include "Graphs/SVFG.h"
+#include <functional>
+
+namespace SVF {
+
+/// Run f on threadNum contiguous id ranges of [0, nodeNum), one thread per range
+void forEachIDRange(u32_t nodeNum, u32_t threadNum, const std::function<void(NodeID, NodeID)> &f);
+
+/*!
+ * Compressed sparse row (CSR) adjacency keyed by node id
+ *
+ * The neighbours of id are _targets[_offsets[id], _offsets[id + 1]). A counting
+ * pass fills the offsets and a second pass the targets, both split over threads
+ * by id range, so each thread writes its own slots.
+ */
+template<typename T>
+class CSRAdjacency {
+public:
+    typedef typename std::vector<T>::const_iterator const_iterator;
+
+    /// Neighbours of a node
+    class Range {
+    private:
+        const_iterator _begin;
+        const_iterator _end;
+    public:
+        Range(const_iterator begin, const_iterator end) : _begin(begin), _end(end) {}
+
+        inline const_iterator begin() const {
+            return _begin;
+        }
+
+        inline const_iterator end() const {
+            return _end;
+        }
+
+        inline bool empty() const {
+            return _begin == _end;
+        }
+    };
+
+private:
+    std::vector<u32_t> _offsets;
+    std::vector<T> _targets;
+
+public:
+    /// Neighbours of id, empty if id was not numbered
+    inline Range operator[](NodeID id) const {
+        if (id + 1 >= _offsets.size()) return Range(_targets.end(), _targets.end());
+        return Range(_targets.begin() + _offsets[id], _targets.begin() + _offsets[id + 1]);
+    }
+
+    /// collect(id, targets) appends the neighbours of id, it is called twice per id, from several threads
+    template<typename Collect>
+    void build(u32_t nodeNum, u32_t threadNum, Collect collect) {
+        _offsets.assign(nodeNum + 1, 0);
+        forEachIDRange(nodeNum, threadNum, [&](NodeID begin, NodeID end) {
+            std::vector<T> targets;
+            for (NodeID id = begin; id < end; ++id) {
+                targets.clear();
+                collect(id, targets);
+                _offsets[id + 1] = targets.size();
+            }
+        });
+        for (NodeID id = 0; id < nodeNum; ++id)
+            _offsets[id + 1] += _offsets[id];
+        _targets.resize(_offsets[nodeNum]);
+        forEachIDRange(nodeNum, threadNum, [&](NodeID begin, NodeID end) {
+            std::vector<T> targets;
+            for (NodeID id = begin; id < end; ++id) {
+                targets.clear();
+                collect(id, targets);
+                std::copy(targets.begin(), targets.end(), _targets.begin() + _offsets[id]);
+            }
+        });
+    }
+
+    inline bool isBuilt() const {
+        return !_offsets.empty();
+    }
+
+    inline u32_t getTargetNum() const {
+        return _targets.size();
+    }
+
+    inline u64_t getMemoryBytes() const {
+        return _offsets.capacity() * sizeof(u32_t) + _targets.capacity() * sizeof(T);
+    }
+
+    inline void clear() {
+        std::vector<u32_t>().swap(_offsets);
+        std::vector<T>().swap(_targets);
+    }
+}; // end class CSRAdjacency
+
+/*!
+ * CSR adjacency of an SVFG
+ *
+ * Holds the def-use edges in both directions with their call site ids, and the
+ * actual out -> actual ins / actual in -> actual outs jumps packed from FSMHandler,
+ * so that the context-sensitive traversals neither hash nor chase edge pointers.
+ * init only numbers the svfg; each part is packed once, by the first phase that
+ * traverses it, and never from the (const) accessors.
+ */
+class SVFGAdjacency {
+public:
+    enum EdgeKind {
+        IntraEdge,
+        CallEdge,
+        RetEdge
+    };
+
+    /// A def-use edge seen from one of its ends
+    struct Edge {
+        const SVFGNode *node{nullptr}; ///< the other end of the edge
+        CallSiteID csId{0};            ///< call site of a call/ret edge
+        EdgeKind kind{IntraEdge};
+
+        inline bool isIntra() const {
+            return kind == IntraEdge;
+        }
+
+        inline bool isCall() const {
+            return kind == CallEdge;
+        }
+
+        inline bool isRet() const {
+            return kind == RetEdge;
+        }
+    };
+
+    typedef CSRAdjacency<Edge> EdgeCSR;
+    typedef CSRAdjacency<const SVFGNode *> NodeCSR;
+    typedef Map<const SVFGNode *, Set<const SVFGNode *>> JumpMap;
+
+private:
+    const SVFG *_svfg{nullptr};
+    u32_t _nodeNum{0};
+    EdgeCSR _inEdges;
+    EdgeCSR _outEdges;
+    NodeCSR _outToIns;
+    NodeCSR _inToOuts;
+
+public:
+    /// Drop the packed parts and number the nodes of svfg
+    void init(const SVFG *svfg);
+
+    /// Pack the def-use edges of one direction, no-op if already packed
+    //{%
+    inline void buildInEdges() {
+        if (!_inEdges.isBuilt()) buildEdges(_inEdges, true);
+    }
+
+    inline void buildOutEdges() {
+        if (!_outEdges.isBuilt()) buildEdges(_outEdges, false);
+    }
+    //%}
+
+    /// Pack the jumps of the nodes of the svfg, no-op if already packed
+    //{%
+    inline void packOutToIns(const JumpMap &outToIns) {
+        if (!_outToIns.isBuilt()) packJumps(outToIns, _outToIns);
+    }
+
+    inline void packInToOuts(const JumpMap &inToOuts) {
+        if (!_inToOuts.isBuilt()) packJumps(inToOuts, _inToOuts);
+    }
+    //%}
+
+    inline EdgeCSR::Range getInEdges(const SVFGNode *node) const {
+        return _inEdges[node->getId()];
+    }
+
+    inline EdgeCSR::Range getOutEdges(const SVFGNode *node) const {
+        return _outEdges[node->getId()];
+    }
+
+    inline NodeCSR::Range getActualInsOfActualOut(const SVFGNode *actualOut) const {
+        return _outToIns[actualOut->getId()];
+    }
+
+    inline NodeCSR::Range getActualOutsOfActualIn(const SVFGNode *actualIn) const {
+        return _inToOuts[actualIn->getId()];
+    }
+
+    inline u64_t getMemoryBytes() const {
+        return _inEdges.getMemoryBytes() + _outEdges.getMemoryBytes() + _outToIns.getMemoryBytes() +
+               _inToOuts.getMemoryBytes();
+    }
+
+    void clear();
+
+private:
+    void buildEdges(EdgeCSR &csr, bool in);
+
+    void packJumps(const JumpMap &jumps, NodeCSR &csr);
+
+    static Edge toEdge(const SVFGEdge *edge, const SVFGNode *node);
+}; // end class SVFGAdjacency
+} // end namespace SVF
+
+#endif //PSA_SVFGADJACENCY_H
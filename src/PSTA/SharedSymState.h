@@ -0,0 +1,62 @@
+#ifndef PSA_SHAREDSYMSTATE_H
+#define PSA_SHAREDSYMSTATE_H
+
+#include "AE/Core/SymState.h"
+#include <memory>
+
+namespace SVF {
+
+/*!
+ * Copy-on-write handle of a symstate
+ *
+ * Copying a handle only bumps a reference count, so the same symstate
+ * propagated to several edges is stored once. The execution state is
+ * duplicated only when a shared handle is written.
+ */
+class SharedSymState {
+private:
+    std::shared_ptr<SymState> _state;
+
+public:
+    SharedSymState() = default;
+
+    explicit SharedSymState(SymState symState) : _state(std::make_shared<SymState>(SVFUtil::move(symState))) {}
+
+    inline bool isNullSymState() const {
+        return !_state || _state->isNullSymState();
+    }
+
+    /// Read access, never copies
+    inline const SymState &get() const {
+        assert(_state && "null shared symstate!");
+        return *_state;
+    }
+
+    /// Write access, detaches from other handles first
+    inline SymState &mut() {
+        assert(_state && "null shared symstate!");
+        if (_state.use_count() > 1) _state = std::make_shared<SymState>(*_state);
+        return *_state;
+    }
+
+    /// Take the symstate out, moving it if this is the last handle
+    inline SymState release() {
+        assert(_state && "null shared symstate!");
+        SymState symState = _state.use_count() > 1 ? *_state : SVFUtil::move(*_state);
+        _state.reset();
+        return symState;
+    }
+
+    inline bool isShared() const {
+        return _state.use_count() > 1;
+    }
+
+    /// Identity of the underlying symstate
+    inline const SymState *getStatePtr() const {
+        return _state.get();
+    }
+};
+
+} // end namespace SVF
+
+#endif //PSA_SHAREDSYMSTATE_H
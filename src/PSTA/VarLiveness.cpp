@@ -0,0 +1,137 @@
+#include "PSTA/VarLiveness.h"
+
+using namespace SVF;
+using namespace SVFUtil;
+
+const NodeBS &VarLiveness::getLiveOut(const ICFGNode *node) {
+    if (!node->getFun()) return _emptyVars;
+    if (!_funDefs.count(node->getFun())) computeFunction(node->getFun());
+    auto it = _liveOuts.find(node->getId());
+    return it == _liveOuts.end() ? _emptyVars : it->second;
+}
+
+const NodeBS &VarLiveness::getFunDefs(const SVFFunction *fun) {
+    if (!_funDefs.count(fun)) computeFunction(fun);
+    return _funDefs[fun];
+}
+
+void VarLiveness::getSuccs(const ICFGNode *node, std::vector<const ICFGNode *> &succs) {
+    if (const CallICFGNode *callNode = dyn_cast<CallICFGNode>(node)) {
+        succs.push_back(callNode->getRetICFGNode());
+        return;
+    }
+    for (const auto &e: node->getOutEdges()) {
+        if (isa<IntraCFGEdge>(e)) succs.push_back(e->getDstNode());
+    }
+}
+
+void VarLiveness::getPreds(const ICFGNode *node, std::vector<const ICFGNode *> &preds) {
+    if (const RetICFGNode *retNode = dyn_cast<RetICFGNode>(node)) {
+        preds.push_back(retNode->getCallICFGNode());
+        return;
+    }
+    for (const auto &e: node->getInEdges()) {
+        if (isa<IntraCFGEdge>(e)) preds.push_back(e->getSrcNode());
+    }
+}
+
+void VarLiveness::transfer(const ICFGNode *node, NodeBS &live, NodeBS *defs) {
+    // boundary uses and defs not carried by statements
+    if (const FunExitICFGNode *exitNode = dyn_cast<FunExitICFGNode>(node)) {
+        if (exitNode->getFormalRet()) live.set(exitNode->getFormalRet()->getId());
+    } else if (const CallICFGNode *callNode = dyn_cast<CallICFGNode>(node)) {
+        for (const auto &param: callNode->getActualParms())
+            live.set(param->getId());
+    }
+    const SVFStmtList &stmts = node->getSVFStmts();
+    for (auto it = stmts.rbegin(); it != stmts.rend(); ++it) {
+        const SVFStmt *stmt = *it;
+        if (isa<CallPE>(stmt) || isa<RetPE>(stmt)) {
+            live.set(cast<AssignStmt>(stmt)->getRHSVarID());
+        } else if (const StoreStmt *store = dyn_cast<StoreStmt>(stmt)) {
+            live.set(store->getLHSVarID());
+            live.set(store->getRHSVarID());
+        } else if (const AddrStmt *addr = dyn_cast<AddrStmt>(stmt)) {
+            live.reset(addr->getLHSVarID());
+            if (defs) defs->set(addr->getLHSVarID());
+        } else if (const AssignStmt *assign = dyn_cast<AssignStmt>(stmt)) {
+            live.reset(assign->getLHSVarID());
+            live.set(assign->getRHSVarID());
+            if (defs) defs->set(assign->getLHSVarID());
+        } else if (const MultiOpndStmt *multi = dyn_cast<MultiOpndStmt>(stmt)) {
+            live.reset(multi->getResID());
+            for (const auto &opnd: multi->getOpndVars())
+                live.set(opnd->getId());
+            if (const SelectStmt *select = dyn_cast<SelectStmt>(stmt))
+                live.set(select->getCondition()->getId());
+            if (defs) defs->set(multi->getResID());
+        } else if (const UnaryOPStmt *unary = dyn_cast<UnaryOPStmt>(stmt)) {
+            live.reset(unary->getResID());
+            live.set(unary->getOpVarID());
+            if (defs) defs->set(unary->getResID());
+        } else if (const BranchStmt *branch = dyn_cast<BranchStmt>(stmt)) {
+            live.set(branch->getCondition()->getId());
+        }
+    }
+    if (const FunEntryICFGNode *entryNode = dyn_cast<FunEntryICFGNode>(node)) {
+        for (const auto &param: entryNode->getFormalParms()) {
+            live.reset(param->getId());
+            if (defs) defs->set(param->getId());
+        }
+    }
+}
+
+/*!
+ * Backward fixpoint over the intra-procedural nodes of fun
+ *
+ * The exit node keeps the formal return live, everything else
+ * defined in fun is dead once fun returns
+ */
+void VarLiveness::computeFunction(const SVFFunction *fun) {
+    NodeBS &defs = _funDefs[fun];
+    ICFG *icfg = PAG::getPAG()->getICFG();
+    const ICFGNode *entry = icfg->getFunEntryICFGNode(fun);
+
+    // collect nodes and defs
+    std::vector<const ICFGNode *> nodes;
+    Set<const ICFGNode *> visited;
+    FIFOWorkList<const ICFGNode *> workList;
+    workList.push(entry);
+    visited.insert(entry);
+    while (!workList.empty()) {
+        const ICFGNode *cur = workList.pop();
+        nodes.push_back(cur);
+        NodeBS tmp;
+        transfer(cur, tmp, &defs);
+        std::vector<const ICFGNode *> succs;
+        getSuccs(cur, succs);
+        for (const auto &succ: succs) {
+            if (visited.insert(succ).second) workList.push(succ);
+        }
+    }
+
+    Map<const ICFGNode *, NodeBS> liveIns;
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it)
+        workList.push(*it);
+    while (!workList.empty()) {
+        const ICFGNode *cur = workList.pop();
+        NodeBS &liveOut = _liveOuts[cur->getId()];
+        if (const FunExitICFGNode *exitNode = dyn_cast<FunExitICFGNode>(cur)) {
+            if (exitNode->getFormalRet()) liveOut.set(exitNode->getFormalRet()->getId());
+        }
+        std::vector<const ICFGNode *> succs;
+        getSuccs(cur, succs);
+        for (const auto &succ: succs)
+            liveOut |= liveIns[succ];
+        NodeBS liveIn = liveOut;
+        transfer(cur, liveIn, nullptr);
+        NodeBS &oldLiveIn = liveIns[cur];
+        if (liveIn == oldLiveIn) continue;
+        oldLiveIn = SVFUtil::move(liveIn);
+        std::vector<const ICFGNode *> preds;
+        getPreds(cur, preds);
+        for (const auto &pred: preds) {
+            if (visited.count(pred)) workList.push(pred);
+        }
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef PSA_VARLIVENESS_H
+#define PSA_VARLIVENESS_H
+
+#include "SVFIR/SVFIR.h"
+#include "Util/WorkList.h"
+
+namespace SVF {
+
+/*!
+ * Intra-procedural liveness of top-level variables
+ *
+ * A backward may-analysis over the SVFIR statements of a function,
+ * computed lazily on the first query of the function and kept for
+ * all sources. Interprocedural copies (CallPE/RetPE) only contribute
+ * uses, so variables they define are never reported as dead.
+ */
+class VarLiveness {
+public:
+    typedef Map<NodeID, NodeBS> NodeToVars;
+    typedef Map<const SVFFunction *, NodeBS> FunToVars;
+
+private:
+    NodeToVars _liveOuts;   ///< icfg node -> top-level vars live after it
+    FunToVars _funDefs;     ///< function -> top-level vars defined in it
+    NodeBS _emptyVars;
+
+public:
+    /// Top-level vars live after node
+    const NodeBS &getLiveOut(const ICFGNode *node);
+
+    /// Top-level vars defined (and thus droppable) in fun
+    const NodeBS &getFunDefs(const SVFFunction *fun);
+
+    inline void clear() {
+        _liveOuts.clear();
+        _funDefs.clear();
+    }
+
+private:
+    /// Solve liveness for all the nodes of fun
+    void computeFunction(const SVFFunction *fun);
+
+    /// Intra-procedural successors, a call node flows to its ret node
+    static void getSuccs(const ICFGNode *node, std::vector<const ICFGNode *> &succs);
+
+    /// Intra-procedural predecessors, a ret node flows from its call node
+    static void getPreds(const ICFGNode *node, std::vector<const ICFGNode *> &preds);
+
+    /// live = (live - defs(node)) + uses(node), statements are visited backward
+    static void transfer(const ICFGNode *node, NodeBS &live, NodeBS *defs);
+};
+
+} // end namespace SVF
+
+#endif //PSA_VARLIVENESS_H
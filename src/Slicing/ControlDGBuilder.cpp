@@ -12,6 +12,9 @@
 #include "ControlDGBuilder.h"
 #include "SVF-LLVM/SVFIRBuilder.h"
 #include "SVF-LLVM/LLVMUtil.h"
+#include "PSTA/PSAOptions.h"
+#include <atomic>
+#include <thread>
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -85,15 +88,13 @@ u32_t ControlDGBuilder::getBBSuccessorPos(const BasicBlock *BB, const BasicBlock
 /*!
  * Build control dependence for each function
  *
- * (1) construct CFG for each function
- * (2) extract basic block edges (pred->succ) on the CFG to be processed
- *     succ does not post-dominates pred (!postDT->dominates(succ, pred))
- * (3) extract nodes from succ to the least common ancestor LCA of pred and succ
- *     including LCA if LCA is pred, excluding LCA if LCA is not pred
+ * Functions are independent, with -cdg-threads=N (N > 1) N threads compute them
+ * into per-function buffers, which are merged in function order afterwards
  * @param svfgModule
  */
 void ControlDGBuilder::buildControlDependence(const SVFModule *svfgModule) {
     LLVMModuleSet *llvmModuleSet = LLVMModuleSet::getLLVMModuleSet();
+    std::vector<const Function *> funcs;
     for (Module &mod: llvmModuleSet->getLLVMModules()) {
         for (Module::iterator it = mod.begin(), eit = mod.end(); it != eit; ++it)
         {
@@ -101,38 +102,76 @@ void ControlDGBuilder::buildControlDependence(const SVFModule *svfgModule) {
             const SVFFunction* svfFun = llvmModuleSet->getSVFFunction(llvmFun);
             if (SVFUtil::isExtCall(svfFun))
                 continue;
-            PostDominatorTree postDT;
-            postDT.recalculate(const_cast<Function &>(*llvmFun));
-            // extract basic block edges to be processed
-            Map<const BasicBlock *, std::vector<const BasicBlock *>> BBS;
-            extractBBS(llvmFun, &postDT, BBS);
-            for (const auto &item: BBS) {
-                const BasicBlock *pred = item.first;
-                // for each bb pair
-                for (const BasicBlock *succ: item.second) {
-                    const BasicBlock *LCA = postDT.findNearestCommonDominator(pred, succ);
-                    std::vector<const BasicBlock *> tgtNodes;
-                    if (LCA == pred) tgtNodes.push_back(LCA);
-                    // from succ to LCA
-                    extractNodesBetweenPdomNodes(succ, LCA, &postDT, tgtNodes);
+            funcs.push_back(llvmFun);
+        }
+    }
+    std::vector<BBControlDeps> funDeps(funcs.size());
+    u32_t threadNum = std::min<u32_t>(PSAOptions::CDGThreads(), funcs.size());
+    if (threadNum > 1) {
+        // functions differ a lot in size, so threads take the next function instead of fixed chunks
+        std::atomic<u32_t> next{0};
+        std::vector<std::thread> threads;
+        for (u32_t t = 0; t < threadNum; ++t) {
+            threads.emplace_back([&funcs, &funDeps, &next]() {
+                for (u32_t i = next++; i < funcs.size(); i = next++)
+                    buildFunControlDependence(funcs[i], funDeps[i]);
+            });
+        }
+        for (auto &thread: threads)
+            thread.join();
+    } else {
+        for (u32_t i = 0; i < funcs.size(); ++i)
+            buildFunControlDependence(funcs[i], funDeps[i]);
+    }
+    for (const auto &deps: funDeps) {
+        for (const auto &dep: deps) {
+            updateMap(std::get<0>(dep), std::get<1>(dep), std::get<2>(dep));
+        }
+    }
+}
 
-                    s32_t pos = getBBSuccessorPos(pred, succ);
-                    if (SVFUtil::isa<BranchInst>(pred->getTerminator())) {
-                        pos = 1 - pos;
-                    } else if (const SwitchInst *si = SVFUtil::dyn_cast<SwitchInst>(pred->getTerminator())) {
-                        /// branch condition value
-                        const ConstantInt *condVal = const_cast<SwitchInst *>(si)->findCaseDest(
-                                const_cast<BasicBlock *>(succ));
-                        /// default case is set to -1;
-                        pos = condVal ? condVal->getSExtValue() : -1;
-                    } else {
-                        // assert(false && "not valid branch");
-                        continue;
-                    }
-                    for (const BasicBlock *bb: tgtNodes) {
-                        updateMap(pred, bb, pos);
-                    }
-                }
+/*!
+ * Control dependence of a function
+ *
+ * (1) construct CFG for each function
+ * (2) extract basic block edges (pred->succ) on the CFG to be processed
+ *     succ does not post-dominates pred (!postDT->dominates(succ, pred))
+ * (3) extract nodes from succ to the least common ancestor LCA of pred and succ
+ *     including LCA if LCA is pred, excluding LCA if LCA is not pred
+ * @param func
+ * @param deps
+ */
+void ControlDGBuilder::buildFunControlDependence(const Function *func, BBControlDeps &deps) {
+    PostDominatorTree postDT;
+    postDT.recalculate(const_cast<Function &>(*func));
+    // extract basic block edges to be processed
+    Map<const BasicBlock *, std::vector<const BasicBlock *>> BBS;
+    extractBBS(func, &postDT, BBS);
+    for (const auto &item: BBS) {
+        const BasicBlock *pred = item.first;
+        // for each bb pair
+        for (const BasicBlock *succ: item.second) {
+            const BasicBlock *LCA = postDT.findNearestCommonDominator(pred, succ);
+            std::vector<const BasicBlock *> tgtNodes;
+            if (LCA == pred) tgtNodes.push_back(LCA);
+            // from succ to LCA
+            extractNodesBetweenPdomNodes(succ, LCA, &postDT, tgtNodes);
+
+            s32_t pos = getBBSuccessorPos(pred, succ);
+            if (SVFUtil::isa<BranchInst>(pred->getTerminator())) {
+                pos = 1 - pos;
+            } else if (const SwitchInst *si = SVFUtil::dyn_cast<SwitchInst>(pred->getTerminator())) {
+                /// branch condition value
+                const ConstantInt *condVal = const_cast<SwitchInst *>(si)->findCaseDest(
+                        const_cast<BasicBlock *>(succ));
+                /// default case is set to -1;
+                pos = condVal ? condVal->getSExtValue() : -1;
+            } else {
+                // assert(false && "not valid branch");
+                continue;
+            }
+            for (const BasicBlock *bb: tgtNodes) {
+                deps.emplace_back(pred, bb, pos);
             }
         }
     }
@@ -104,21 +104,28 @@ public:
         return _nodeControlMap[lnode].count(rnode);
     }
 
-    u32_t getBBSuccessorPos(const BasicBlock *BB, const BasicBlock *Succ);
+    static u32_t getBBSuccessorPos(const BasicBlock *BB, const BasicBlock *Succ);
 
 private:
+    /// A control dependence: pred controls bb at pos
+    typedef std::tuple<const BasicBlock *, const BasicBlock *, s32_t> BBControlDep;
+    typedef std::vector<BBControlDep> BBControlDeps;
+
+    /// compute the control dependence of a function, touching no builder state
+    static void buildFunControlDependence(const Function *func, BBControlDeps &deps);
+
     /// extract basic block edges to be processed
     static void
     extractBBS(const Function *func, const PostDominatorTree *postDT,
                Map<const BasicBlock *, std::vector<const BasicBlock *>> &res);
 
     /// extract nodes between two nodes in pdom tree
-    void
+    static void
     extractNodesBetweenPdomNodes(const BasicBlock *succ, const BasicBlock *LCA, const PostDominatorTree *postDT,
                                  std::vector<const BasicBlock *> &tgtNodes);
 
     /// dfs - extract nodes between two nodes in pdom tree
-    void dfsNodesBetweenPdomNodes(const llvm::DomTreeNodeBase<BasicBlock> *cur,
+    static void dfsNodesBetweenPdomNodes(const llvm::DomTreeNodeBase<BasicBlock> *cur,
                                   const llvm::DomTreeNodeBase<BasicBlock> *tgt,
                                   std::vector<const BasicBlock *> &path,
                                   std::vector<const BasicBlock *> &tgtNodes);
@@ -0,0 +1,60 @@
+#include "Slicing/DenseNodeSet.h"
+
+using namespace SVF;
+using namespace SVFUtil;
+
+DenseIDMap &DenseIDMap::getICFGIDMap() {
+    static DenseIDMap icfgIDMap;
+    return icfgIDMap;
+}
+
+DenseIDMap &DenseIDMap::getSVFGIDMap() {
+    static DenseIDMap svfgIDMap;
+    return svfgIDMap;
+}
+
+void DenseIDMap::build(ICFG *icfg) {
+    clear();
+    Map<const SVFFunction *, std::vector<u32_t>> funToIds;
+    std::vector<u32_t> globalIds;
+    for (const auto &item: *icfg) {
+        if (const SVFFunction *fun = item.second->getFun())
+            funToIds[fun].push_back(item.first);
+        else
+            globalIds.push_back(item.first);
+    }
+    addGroups(funToIds, globalIds);
+}
+
+void DenseIDMap::build(SVFG *svfg) {
+    clear();
+    Map<const SVFFunction *, std::vector<u32_t>> funToIds;
+    std::vector<u32_t> globalIds;
+    for (const auto &item: *svfg) {
+        if (const SVFFunction *fun = item.second->getFun())
+            funToIds[fun].push_back(item.first);
+        else
+            globalIds.push_back(item.first);
+    }
+    addGroups(funToIds, globalIds);
+}
+
+/*!
+ * Number global ids first, then each function in id order of its first node
+ *
+ * The graphs are iterated in id order, so ids inside a group stay sorted
+ */
+void DenseIDMap::addGroups(Map<const SVFFunction *, std::vector<u32_t>> &funToIds, std::vector<u32_t> &globalIds) {
+    std::vector<std::vector<u32_t> *> groups;
+    for (auto &item: funToIds)
+        groups.push_back(&item.second);
+    std::sort(groups.begin(), groups.end(), [](const std::vector<u32_t> *lhs, const std::vector<u32_t> *rhs) {
+        return lhs->front() < rhs->front();
+    });
+    for (const auto &id: globalIds)
+        toDense(id);
+    for (const auto &group: groups) {
+        for (const auto &id: *group)
+            toDense(id);
+    }
+}
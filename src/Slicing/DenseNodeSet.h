@@ -0,0 +1,183 @@
+#ifndef PSA_DENSENODESET_H
+#define PSA_DENSENODESET_H
+
+#include "Graphs/SVFG.h"
+
+namespace SVF {
+
+/*!
+ * Dense renumbering of graph node ids
+ *
+ * Nodes are numbered function by function, so the nodes of a function
+ * share the words of a bitset. Ids not seen when building the map
+ * (e.g., SVFG nodes created later) are appended on first lookup.
+ *
+ * Appending resizes the map, so it is not thread-safe. Maps are built
+ * before any parallel phase and frozen while it runs: sets of a frozen
+ * map may be read from several threads, appending to it asserts.
+ */
+class DenseIDMap {
+private:
+    static const u32_t Unmapped = UINT32_MAX;
+
+    std::vector<u32_t> _toDense; ///< original id -> dense id
+    std::vector<u32_t> _toOrig;  ///< dense id -> original id
+    bool _frozen{false};         ///< no id may be appended
+
+public:
+    /// One map per id space, built once per module
+    //{%
+    static DenseIDMap &getICFGIDMap();
+
+    static DenseIDMap &getSVFGIDMap();
+    //%}
+
+    /// Number the nodes of icfg/svfg grouped by their functions
+    //{%
+    void build(ICFG *icfg);
+
+    void build(SVFG *svfg);
+    //%}
+
+    inline u32_t toDense(u32_t id) {
+        if (id < _toDense.size() && _toDense[id] != Unmapped)
+            return _toDense[id];
+        assert(!_frozen && "id appended to a frozen map, build the map before the parallel phase");
+        if (id >= _toDense.size()) _toDense.resize(id + 1, Unmapped);
+        _toDense[id] = _toOrig.size();
+        _toOrig.push_back(id);
+        return _toDense[id];
+    }
+
+    /// Dense id of id, or Unmapped if id was never numbered
+    inline u32_t findDense(u32_t id) const {
+        return id < _toDense.size() ? _toDense[id] : Unmapped;
+    }
+
+    inline u32_t toOrig(u32_t dense) const {
+        assert(dense < _toOrig.size() && "dense id not mapped?");
+        return _toOrig[dense];
+    }
+
+    inline bool empty() const {
+        return _toOrig.empty();
+    }
+
+    /// Freeze the map for a parallel phase
+    inline void setFrozen(bool frozen) {
+        _frozen = frozen;
+    }
+
+    inline void clear() {
+        _toDense.clear();
+        _toOrig.clear();
+    }
+
+private:
+    void addGroups(Map<const SVFFunction *, std::vector<u32_t>> &funToIds, std::vector<u32_t> &globalIds);
+}; // end class DenseIDMap
+
+/*!
+ * Node id set on a compressed bitset keyed by dense ids
+ *
+ * Drop-in for the Set<u32_t> node sets of slicing: insert/count/iteration
+ * take and yield original ids, unions and intersections are word operations.
+ */
+class DenseNodeSet {
+private:
+    DenseIDMap *_idMap;
+    NodeBS _bits;
+
+public:
+    class const_iterator {
+    private:
+        const DenseIDMap *_idMap;
+        NodeBS::iterator _it;
+    public:
+        const_iterator(const DenseIDMap *idMap, NodeBS::iterator it) : _idMap(idMap), _it(it) {}
+
+        inline u32_t operator*() const {
+            return _idMap->toOrig(*_it);
+        }
+
+        inline const_iterator &operator++() {
+            ++_it;
+            return *this;
+        }
+
+        inline bool operator==(const const_iterator &rhs) const {
+            return _it == rhs._it;
+        }
+
+        inline bool operator!=(const const_iterator &rhs) const {
+            return _it != rhs._it;
+        }
+    };
+
+    typedef const_iterator iterator;
+
+    /// ICFG node ids by default
+    DenseNodeSet() : _idMap(&DenseIDMap::getICFGIDMap()) {}
+
+    explicit DenseNodeSet(DenseIDMap &idMap) : _idMap(&idMap) {}
+
+    /// Insert id, return true if it was not in the set
+    inline bool insert(u32_t id) {
+        return _bits.test_and_set(_idMap->toDense(id));
+    }
+
+    inline u32_t count(u32_t id) const {
+        u32_t dense = _idMap->findDense(id);
+        return dense != UINT32_MAX && _bits.test(dense);
+    }
+
+    inline void erase(u32_t id) {
+        u32_t dense = _idMap->findDense(id);
+        if (dense != UINT32_MAX) _bits.reset(dense);
+    }
+
+    inline u32_t size() const {
+        return _bits.count();
+    }
+
+    inline bool empty() const {
+        return _bits.empty();
+    }
+
+    inline void clear() {
+        _bits.clear();
+    }
+
+    inline const_iterator begin() const {
+        return const_iterator(_idMap, _bits.begin());
+    }
+
+    inline const_iterator end() const {
+        return const_iterator(_idMap, _bits.end());
+    }
+
+    /// Word operations, both sets must share the id map
+    //{%
+    inline bool operator|=(const DenseNodeSet &rhs) {
+        assert(_idMap == rhs._idMap && "different id spaces!");
+        return _bits |= rhs._bits;
+    }
+
+    inline bool operator&=(const DenseNodeSet &rhs) {
+        assert(_idMap == rhs._idMap && "different id spaces!");
+        return _bits &= rhs._bits;
+    }
+
+    inline bool intersects(const DenseNodeSet &rhs) const {
+        assert(_idMap == rhs._idMap && "different id spaces!");
+        return _bits.intersects(rhs._bits);
+    }
+
+    inline bool operator==(const DenseNodeSet &rhs) const {
+        return _idMap == rhs._idMap && _bits == rhs._bits;
+    }
+    //%}
+}; // end class DenseNodeSet
+} // end namespace SVF
+
+#endif //PSA_DENSENODESET_H
@@ -44,7 +44,25 @@ GraphSparsificator::multipointSlicing(SVFModule *svfModule, Set<FSMParser::CHECK
     // rebuild icfgwrapper after extracting PI
     ICFGWrapperBuilder builder;
     ICFG *icfg = PAG::getPAG()->getICFG();
-    builder.build(icfg);
+    if (PSAOptions::LazyWrapper()) {
+        // materialize the functions of the source, its callees and the key nodes of PI and sinks
+        const ICFGNode *srcNode = src->getICFGNode();
+        if (const RetICFGNode *n = dyn_cast<RetICFGNode>(srcNode))
+            srcNode = n->getCallICFGNode();
+        Set<const SVFFunction *> curEvalFuns, demandFuns;
+        for (const auto &e: srcNode->getOutEdges()) {
+            if (const CallCFGEdge *callEdge = dyn_cast<CallCFGEdge>(e))
+                curEvalFuns.insert(callEdge->getDstNode()->getFun());
+        }
+        Set<NodeID> keyNodes;
+        for (const auto &df: _PI)
+            keyNodes.insert(df.begin(), df.end());
+        for (const auto &snk: snks)
+            keyNodes.insert(snk->getId());
+        ICFGWrapperBuilder::collectDemandFuns(srcNode, curEvalFuns, keyNodes, demandFuns);
+        builder.buildLazy(icfg, demandFuns);
+    } else
+        builder.build(icfg);
 
     // extract multi-point temporal slice
     _stat->ntStart();
@@ -109,6 +127,47 @@ void GraphSparsificator::initSnkMapViaSQ(const SVFGNode *src, ICFGNodeSet &snks)
     Dump() << SVFUtil::sucMsg("[done]\n");
 }
 
+/*!
+ * Materialize every function touched by N_t, N_s and the callsites, then freeze the wrapper
+ *
+ * Compaction only sees materialized functions. Freezing removes the remaining stubs
+ * and stops later queries of the solver from cloning functions (uncompacted) again.
+ * @param curEvalFuns
+ * @param snks
+ */
+void GraphSparsificator::materializeSlices(Set<const SVFFunction *> &curEvalFuns,
+                                           OrderedSet<const ICFGNode *> &snks) {
+    const std::unique_ptr<ICFGWrapper> &icfgWrapper = getICFGWrapper();
+    if (!PSAOptions::EnableTemporalSlicing() && !PSAOptions::EnableSpatialSlicing()) {
+        // the graph is not sliced, keep all the functions reachable from the wrapper
+        icfgWrapper->materializeAll();
+        icfgWrapper->freeze();
+        return;
+    }
+    ICFG *icfg = PAG::getPAG()->getICFG();
+    auto materializeNode = [&](NodeID id) {
+        const ICFGNode *node = icfg->getICFGNode(id);
+        icfgWrapper->materializeFunction(node->getFun());
+        if (const CallICFGNode *callNode = dyn_cast<CallICFGNode>(node)) {
+            for (const auto &e: callNode->getOutEdges()) {
+                if (e->isCallCFGEdge())
+                    icfgWrapper->materializeFunction(e->getDstNode()->getFun());
+            }
+        }
+    };
+    for (const auto &id: _temporalSlice)
+        materializeNode(id);
+    for (const auto &id: _spatialSlice)
+        materializeNode(id);
+    for (const auto &id: _callsites)
+        materializeNode(id);
+    for (const auto &snk: snks)
+        materializeNode(snk->getId());
+    for (const auto &fun: curEvalFuns)
+        icfgWrapper->materializeFunction(fun);
+    icfgWrapper->freeze();
+}
+
 /*!
  * Compact graph for preprocessing (multi-point slicing)
  * @param curEvalSVFGNode
@@ -122,6 +181,8 @@ GraphSparsificator::compactGraph(const SVFGNode *curEvalSVFGNode, const ICFGNode
     Log(LogLevel::Info) << "Compacting graph...";
     Dump() << "Compacting graph...";
     ICFG *icfg = PAG::getPAG()->getICFG();
+    if (getICFGWrapper()->isLazy())
+        materializeSlices(curEvalFuns, snks);
     if (PSAOptions::DumpICFGWrapper()) {
         Set<u32_t> fsmNodes;
         if (!PSAOptions::MultiSlicing()) {
@@ -295,18 +356,26 @@ GraphSparsificator::compactGraph(const SVFGNode *curEvalSVFGNode, const ICFGNode
         }
     }
     removeFSMNodeBody(curEvalICFGNode, curEvalFuns);
-    for (const auto &node: nodesToRemove) {
-        if (isa<GlobalICFGNode>(node->getICFGNode())) continue;
-        getICFGWrapper()->removeICFGNodeWrapper(node);
-    }
-    for (const auto &node: callNodesToCompact) {
-        compactCallNodes(node);
-    }
+    _stat->addCompactScannedNodeNum(getICFGWrapper()->getNodeWrapperNum());
+    if (PSAOptions::RebuildCompaction()) {
+        rebuildCompactedGraph(nodesToRemove, callNodesToCompact, intraNodesToCompact);
+    } else {
+        for (const auto &node: nodesToRemove) {
+            if (isa<GlobalICFGNode>(node->getICFGNode())) continue;
+            getICFGWrapper()->removeICFGNodeWrapper(node);
+        }
+        for (const auto &node: callNodesToCompact) {
+            compactCallNodes(node);
+        }
 
-    for (const auto &node: intraNodesToCompact) {
-        compactIntraNodes(node);
+        for (const auto &node: intraNodesToCompact) {
+            compactIntraNodes(node);
+        }
     }
 
+    if (PSAOptions::BlockWrapper())
+        compactBlockNodes(curEvalICFGNode, snks);
+
 
     if (PSAOptions::DumpICFGWrapper()) {
         getICFGWrapper()->removeFilledColor();
@@ -316,6 +385,148 @@ GraphSparsificator::compactGraph(const SVFGNode *curEvalSVFGNode, const ICFGNode
     Dump() << SVFUtil::sucMsg("[done]\n");
 }
 
+/*!
+ * Remove and bypass the collected nodes in one pass over the kept nodes
+ *
+ * Same result as removing nodesToRemove and then compacting the call and intra nodes
+ * one by one: a kept node gets an edge to every kept node reachable through compacted
+ * nodes, labelled with its own out edge. Edges between kept nodes are left untouched,
+ * so bypass edges are only computed once per kept node instead of re-scanning
+ * the edge sets each time a node is compacted
+ * @param nodesToRemove
+ * @param callNodesToCompact
+ * @param intraNodesToCompact
+ */
+void GraphSparsificator::rebuildCompactedGraph(const Set<ICFGNodeWrapper *> &nodesToRemove,
+                                               const Set<ICFGNodeWrapper *> &callNodesToCompact,
+                                               const Set<ICFGNodeWrapper *> &intraNodesToCompact) {
+    // nodes whose edges are dropped, ret nodes of compacted callsites included
+    Set<ICFGNodeWrapper *> dropped;
+    for (const auto &node: nodesToRemove) {
+        if (!isa<GlobalICFGNode>(node->getICFGNode())) dropped.insert(node);
+    }
+    for (const auto &node: callNodesToCompact) {
+        dropped.insert(node);
+        dropped.insert(node->getRetICFGNodeWrapper());
+    }
+    for (const auto &node: intraNodesToCompact) {
+        dropped.insert(node);
+    }
+
+    // bypass edges of the kept nodes next to dropped ones
+    struct BypassEdge {
+        ICFGNodeWrapper *src;
+        ICFGNodeWrapper *dst;
+        ICFGEdge *icfgEdge;
+    };
+    std::vector<BypassEdge> bypassEdges;
+    Set<ICFGNodeWrapper *> keptSrcs;
+    for (const auto &node: dropped) {
+        for (const auto &e: node->getInEdges()) {
+            if (!dropped.count(e->getSrcNode())) keptSrcs.insert(e->getSrcNode());
+        }
+    }
+    for (const auto &src: keptSrcs) {
+        Set<ICFGNodeWrapper *> visited;
+        for (const auto &e: src->getOutEdges()) {
+            if (!dropped.count(e->getDstNode())) continue;
+            // follow compacted nodes, the bypass edge keeps the label of src's out edge
+            FIFOWorkList<ICFGNodeWrapper *> workList;
+            workList.push(e->getDstNode());
+            while (!workList.empty()) {
+                ICFGNodeWrapper *cur = workList.pop();
+                if (!dropped.count(cur)) {
+                    bypassEdges.push_back({src, cur, e->getICFGEdge()});
+                    continue;
+                }
+                if (!visited.insert(cur).second) continue;
+                const ICFGNodeWrapper *succsOf = nullptr;
+                if (callNodesToCompact.count(cur)) succsOf = cur->getRetICFGNodeWrapper();
+                else if (intraNodesToCompact.count(cur)) succsOf = cur;
+                if (!succsOf) continue;
+                for (const auto &outEdge: succsOf->getOutEdges())
+                    workList.push(outEdge->getDstNode());
+            }
+        }
+    }
+
+    // drop nodes with their edges
+    for (const auto &node: dropped) {
+        getICFGWrapper()->removeICFGNodeWrapper(node);
+    }
+
+    // same dedup rule as compactIntraNodes/compactCallNodes
+    for (const auto &edge: bypassEdges) {
+        if (!getICFGWrapper()->hasICFGEdgeWrapper(edge.src, edge.dst)) {
+            getICFGWrapper()->addICFGEdgeWrapper(new ICFGEdgeWrapper(edge.src, edge.dst, edge.icfgEdge));
+        } else if (const IntraCFGEdge *intraEdge = SVFUtil::dyn_cast_or_null<IntraCFGEdge>(edge.icfgEdge)) {
+            if (intraEdge->getCondition() &&
+                !getICFGWrapper()->hasICFGEdgeWrapper(edge.src, edge.dst, edge.icfgEdge)) {
+                getICFGWrapper()->addICFGEdgeWrapper(new ICFGEdgeWrapper(edge.src, edge.dst, edge.icfgEdge));
+            }
+        }
+    }
+}
+
+/*!
+ * Whether node may be a member of a super-node
+ *
+ * Only plain intra nodes without branching or FSM actions, and that are
+ * neither the src nor a snk (their wrapper nodes are looked up later)
+ */
+bool GraphSparsificator::isBlockCandidate(const ICFGNodeWrapper *node, const ICFGNode *curEvalICFGNode,
+                                          OrderedSet<const ICFGNode *> &snks) const {
+    const ICFGNode *icfgNode = node->getICFGNode();
+    if (!SVFUtil::isa<IntraICFGNode>(icfgNode)) return false;
+    if (icfgNode == curEvalICFGNode || snks.count(icfgNode)) return false;
+    if (getAbsTransitionHandler()->getICFGAbsTransferMap().count(icfgNode)) return false;
+    for (const auto &edge: icfgNode->getOutEdges()) {
+        if (const IntraCFGEdge *intraCfgEdge = SVFUtil::dyn_cast<IntraCFGEdge>(edge)) {
+            if (intraCfgEdge->getCondition()) return false;
+        }
+    }
+    return true;
+}
+
+/*!
+ * Collapse maximal single-entry/single-exit chains into super-nodes
+ *
+ * A chain head keeps its wrapper node, the following nodes are recorded in
+ * the head's _blockMembers and their out edges are moved to the head, so the
+ * chain costs one worklist item and one info entry
+ * @param curEvalICFGNode
+ * @param snks
+ */
+void GraphSparsificator::compactBlockNodes(const ICFGNode *curEvalICFGNode, OrderedSet<const ICFGNode *> &snks) {
+    std::vector<ICFGNodeWrapper *> heads;
+    for (const auto &item: *getICFGWrapper()) {
+        if (isBlockCandidate(item.second, curEvalICFGNode, snks))
+            heads.push_back(item.second);
+    }
+    Set<const ICFGNodeWrapper *> merged;
+    for (const auto &head: heads) {
+        if (merged.count(head)) continue;
+        while (head->getOutEdges().size() == 1) {
+            ICFGEdgeWrapper *edge = *head->getOutEdges().begin();
+            ICFGNodeWrapper *member = edge->getDstNode();
+            if (member == head || member->getInEdges().size() != 1 ||
+                !isBlockCandidate(member, curEvalICFGNode, snks))
+                break;
+            for (const auto &e: member->getOutEdges()) {
+                ICFGNodeWrapper *dst = e->getDstNode() == member ? head : e->getDstNode();
+                if (!getICFGWrapper()->hasICFGEdgeWrapper(head, dst, e->getICFGEdge()))
+                    getICFGWrapper()->addICFGEdgeWrapper(new ICFGEdgeWrapper(head, dst, e->getICFGEdge()));
+            }
+            head->_blockMembers.push_back(member->getICFGNode());
+            head->_blockMembers.insert(head->_blockMembers.end(), member->_blockMembers.begin(),
+                                       member->_blockMembers.end());
+            merged.insert(member);
+            getICFGWrapper()->removeICFGNodeWrapper(member);
+        }
+    }
+    _stat->addBlockMergedNodeNum(merged.size());
+}
+
 /*!
  * Remove the function body of FSM call node
  * @param curEvalICFGNode
@@ -43,7 +43,7 @@ private:
     NodeIDSet _branch;    ///< map source object (SVFGNode) to the branches needed for analysis
     PI _PI;                  ///< map source object (SVFGNode) to its **reversed** operation sequences (e.g. use->free->malloc),
     ///< return node is used for API operation
-    NodeIDSet _globVars;
+    Set<u32_t> _globVars;   ///< PAG vars, not node ids
     TemporalSlicer _temporalSlicer;
     SpatialSlicer _spatialSlicer;
 
@@ -53,7 +53,7 @@ private:
     SrcToCxtDPItemSetMap _srcToCGDpItems;
     SrcToNodeIDSetMap _srcToBranch;    ///< map source object (SVFGNode) to the branches needed for analysis
     SrcToPI _srcToPI;                  ///< map source object (SVFGNode) to its operation sequences
-    SrcToNodeIDSetMap _srcToGlobVars;
+    Map<const SVFGNode *, Set<u32_t>> _srcToGlobVars;
 
 public:
     explicit GraphSparsificator();
@@ -161,6 +161,8 @@ public:
                       Set<const SVFFunction *> &curEvalFuns, const ICFGNode *mainEntry,
                       OrderedSet<const ICFGNode *> &snks);
 
+    /// Materialize the functions touched by the slices and freeze a lazy wrapper (-lazy-wrapper)
+    void materializeSlices(Set<const SVFFunction *> &curEvalFuns, OrderedSet<const ICFGNode *> &snks);
 
     /// Maps a call node to the name of the called function
     static inline void callee(const CallICFGNode *callBlockNode, FunctionSet &funSet) {
@@ -250,6 +252,18 @@ public:
         getICFGWrapper()->removeICFGNodeWrapper(node);
     }
 
+    /// Remove and bypass the collected nodes in one pass over the kept nodes
+    void rebuildCompactedGraph(const Set<ICFGNodeWrapper *> &nodesToRemove,
+                               const Set<ICFGNodeWrapper *> &callNodesToCompact,
+                               const Set<ICFGNodeWrapper *> &intraNodesToCompact);
+
+    /// Collapse single-entry/single-exit chains into super-nodes
+    void compactBlockNodes(const ICFGNode *curEvalICFGNode, OrderedSet<const ICFGNode *> &snks);
+
+    /// Whether node may be a member of a super-node
+    bool isBlockCandidate(const ICFGNodeWrapper *node, const ICFGNode *curEvalICFGNode,
+                          OrderedSet<const ICFGNode *> &snks) const;
+
     static inline const CallICFGNode *
     isFSMCallNode(const ICFGNodeWrapper *nodeWrapper, const ICFGNode *curEvalICFGNode,
                   Set<const SVFFunction *> &curEvalFuns) {
@@ -3,11 +3,112 @@
 //
 
 #include "ICFGWrapper.h"
+#include "WPA/Andersen.h"
 
 using namespace SVF;
 using namespace SVFUtil;
 
 std::unique_ptr<ICFGWrapper> ICFGWrapper::_icfgWrapper = nullptr;
+ICFGWrapper::FunToICFGNodesMap ICFGWrapper::_funToICFGNodes;
+u32_t ICFGWrapper::_peakNodeWrapperNum = 0;
+u32_t ICFGWrapper::_materializedFunNum = 0;
+
+/*!
+ * Clone the nodes of fun with their out edges
+ *
+ * Interprocedural edges into fun (call edges into the entry, ret edges into ret nodes)
+ * are added as well, their sources become stubs if their functions are not materialized
+ * @param fun
+ */
+void ICFGWrapper::materializeFunction(const SVFFunction *fun) {
+    if (!_lazy || !fun || !_materializedFuns.insert(fun).second) return;
+    _materializedFunNum++;
+    if (_funToICFGNodes.empty()) {
+        for (const auto &item: *_icfg) {
+            _funToICFGNodes[item.second->getFun()].push_back(item.second);
+        }
+    }
+    for (const auto &node: _funToICFGNodes[fun]) {
+        addICFGNodeWrapperFromICFGNode(node);
+        ICFGNodeWrapper *nodeWrapper = getGNode(node->getId());
+        nodeWrapper->_materialized = true;
+        for (const auto &e: node->getInEdges()) {
+            if (!e->isCallCFGEdge() && !e->isRetCFGEdge()) continue;
+            if (!hasICFGNodeWrapper(e->getSrcID()))
+                addICFGNodeWrapper(new ICFGNodeWrapper(e->getSrcNode()));
+            ICFGNodeWrapper *srcNodeWrapper = getGNode(e->getSrcID());
+            if (!hasICFGEdgeWrapper(srcNodeWrapper, nodeWrapper, e))
+                addICFGEdgeWrapper(new ICFGEdgeWrapper(srcNodeWrapper, nodeWrapper, e));
+        }
+    }
+}
+
+/*!
+ * Materialize the functions of the nodes reachable from roots
+ *
+ * A node is materialized before its edges are read, afterwards a traversal from roots
+ * in the same direction sees the same graph as a wrapper built without stubs
+ * @param roots
+ * @param forward along out edges (and call node -> ret node) or in edges (and ret node -> call node)
+ */
+void ICFGWrapper::materializeReachable(const ICFGNodeWrapperVector &roots, bool forward) {
+    if (!_lazy) return;
+    FIFOWorkList<const ICFGNodeWrapper *> workList;
+    NodeBS visited;
+    for (const auto &root: roots) {
+        if (root && visited.test_and_set(root->getId()))
+            workList.push(root);
+    }
+    while (!workList.empty()) {
+        const ICFGNodeWrapper *cur = workList.pop();
+        materializeNode(cur);
+        for (const auto &e: forward ? cur->getOutEdges() : cur->getInEdges()) {
+            const ICFGNodeWrapper *nxt = forward ? e->getDstNode() : e->getSrcNode();
+            if (visited.test_and_set(nxt->getId()))
+                workList.push(nxt);
+        }
+        const ICFGNodeWrapper *nxt = forward ? cur->getRetICFGNodeWrapper() : cur->getCallICFGNodeWrapper();
+        if (nxt && visited.test_and_set(nxt->getId()))
+            workList.push(nxt);
+    }
+}
+
+/*!
+ * Materialize stubs until the wrapper is closed under edge queries
+ *
+ * Afterwards no traversal adds nodes, e.g., for readers on several threads
+ */
+void ICFGWrapper::materializeAll() {
+    if (!_lazy) return;
+    std::vector<const SVFFunction *> funs;
+    do {
+        funs.clear();
+        for (const auto &item: *this) {
+            if (!item.second->_materialized)
+                funs.push_back(item.second->getICFGNode()->getFun());
+        }
+        for (const auto &fun: funs)
+            materializeFunction(fun);
+    } while (!funs.empty());
+}
+
+/*!
+ * Remove the stubs left and turn lazy materialization off
+ *
+ * Afterwards the functions of removed nodes are never cloned again, so later
+ * queries see the same graph as a wrapper built without stubs for those functions
+ */
+void ICFGWrapper::freeze() {
+    if (!_lazy) return;
+    std::vector<ICFGNodeWrapper *> stubs;
+    for (const auto &item: *this) {
+        if (!item.second->_materialized)
+            stubs.push_back(item.second);
+    }
+    for (const auto &stub: stubs)
+        removeICFGNodeWrapper(stub);
+    _lazy = false;
+}
 
 void ICFGWrapper::addICFGNodeWrapperFromICFGNode(const ICFGNode *src) {
 
@@ -44,7 +145,8 @@ void ICFGWrapper::addICFGNodeWrapperFromICFGNode(const ICFGNode *src) {
  * Set in N_t flag based on temporal slice
  * @param N_t
  */
-void ICFGWrapper::annotateTemporalSlice(Set<u32_t> &N_t) {
+void ICFGWrapper::annotateTemporalSlice(DenseNodeSet &N_t) {
+    _tSliceAnnotated = true;
     for (const auto &item: *this) {
         item.second->_inTSlice = false;
     }
@@ -61,7 +163,7 @@ void ICFGWrapper::annotateTemporalSlice(Set<u32_t> &N_t) {
  * @param callSites
  * @param keyNodes
  */
-void ICFGWrapper::annotateMulSlice(Set<u32_t> &N_t, Set<u32_t> &N_s, Set<u32_t> &callSites, const KeyNodes &keyNodes) {
+void ICFGWrapper::annotateMulSlice(DenseNodeSet &N_t, DenseNodeSet &N_s, DenseNodeSet &callSites, const KeyNodes &keyNodes) {
     for (const auto &item: *this) {
         item.second->_bugReport = true;
         item.second->_inTSlice = false;
@@ -133,7 +235,7 @@ void ICFGWrapper::annotateFSMNodes(Set<u32_t> &N) {
  * Set in N_s flag based on spatial slice
  * @param N_s
  */
-void ICFGWrapper::annotateSpatialSlice(Set<u32_t> &N_s) {
+void ICFGWrapper::annotateSpatialSlice(DenseNodeSet &N_s) {
     for (const auto &item: *this) {
         item.second->_inSSlice = false;
     }
@@ -147,7 +249,7 @@ void ICFGWrapper::annotateSpatialSlice(Set<u32_t> &N_s) {
  * Set valid callsites
  * @param N_c
  */
-void ICFGWrapper::annotateCallsites(Set<u32_t> &N_c) {
+void ICFGWrapper::annotateCallsites(DenseNodeSet &N_c) {
     for (const auto &item: *this) {
         item.second->_validCS = false;
     }
@@ -186,4 +288,54 @@ void ICFGWrapperBuilder::build(ICFG *icfg) {
     for (const auto &i: *icfg) {
         icfgWrapper->addICFGNodeWrapperFromICFGNode(i.second);
     }
+}
+
+/*!
+ * Build a wrapper holding demandFuns, main and the global node
+ *
+ * The other functions are stubs (nodes without their bodies), a phase materializes
+ * the ones it traverses (ICFGWrapper::materializeReachable) before traversing them
+ * @param icfg
+ * @param demandFuns
+ */
+void ICFGWrapperBuilder::buildLazy(ICFG *icfg, const Set<const SVFFunction *> &demandFuns) {
+    ICFGWrapper::releaseICFGWrapper();
+    const std::unique_ptr<ICFGWrapper> &icfgWrapper = ICFGWrapper::getICFGWrapper(icfg);
+    icfgWrapper->setLazy(true);
+    icfgWrapper->addICFGNodeWrapperFromICFGNode(icfg->getGlobalICFGNode());
+    if (const SVFFunction *mainFunc = FSMHandler::getAbsTransitionHandler()->getMainFunc())
+        icfgWrapper->materializeFunction(mainFunc);
+    for (const auto &fun: demandFuns) {
+        icfgWrapper->materializeFunction(fun);
+    }
+}
+
+void ICFGWrapperBuilder::collectDemandFuns(const ICFGNode *src, const Set<const SVFFunction *> &curEvalFuns,
+                                           const Set<NodeID> &keyNodes, Set<const SVFFunction *> &demandFuns) {
+    PTACallGraph *callGraph = AndersenWaveDiff::createAndersenWaveDiff(PAG::getPAG())->getPTACallGraph();
+    ICFG *icfg = PAG::getPAG()->getICFG();
+    // call chains to main: callers of the src function
+    FIFOWorkList<const PTACallGraphNode *> workList;
+    if (src->getFun()) workList.push(callGraph->getCallGraphNode(src->getFun()));
+    while (!workList.empty()) {
+        const PTACallGraphNode *cur = workList.pop();
+        if (!demandFuns.insert(cur->getFunction()).second) continue;
+        for (const auto &e: cur->getInEdges())
+            workList.push(e->getSrcNode());
+    }
+    // callees of curEvalFuns
+    Set<const SVFFunction *> visited;
+    for (const auto &fun: curEvalFuns)
+        workList.push(callGraph->getCallGraphNode(fun));
+    while (!workList.empty()) {
+        const PTACallGraphNode *cur = workList.pop();
+        if (!visited.insert(cur->getFunction()).second) continue;
+        demandFuns.insert(cur->getFunction());
+        for (const auto &e: cur->getOutEdges())
+            workList.push(e->getDstNode());
+    }
+    for (const auto &id: keyNodes) {
+        if (const SVFFunction *fun = icfg->getICFGNode(id)->getFun())
+            demandFuns.insert(fun);
+    }
 }
\ No newline at end of file
@@ -9,6 +9,8 @@
 #include "SVFIR/SVFIR.h"
 #include "Slicing/PIState.h"
 #include "AE/Core/SymState.h"
+#include "PSTA/SharedSymState.h"
+#include "Slicing/DenseNodeSet.h"
 
 namespace SVF {
 class ICFGNodeWrapper;
@@ -82,12 +84,15 @@ public:
     Map<PIState::DataFact, Set<PIState::DataFact>> _buDataFactTransferFunc;
     Map<TypeState, AbsToSQState> _piInfoMap;
     Map<TypeState, Set<TypeState>> _snkInfoMap;
+    std::vector<SharedSymState> _infoSlots; ///< ESP infos indexed by (typestate id, index typestate id) (-info-slots)
+    std::vector<u32_t> _infoStamps;         ///< change stamps of the ESP infos, indexed as _infoSlots (-delta-prop)
 
 };
 
 typedef GenericNode<ICFGNodeWrapper, ICFGEdgeWrapper> GenericICFGNodeWrapperTy;
 
 class ICFGNodeWrapper : public GenericICFGNodeWrapperTy {
+    friend class ICFGWrapper;
 public:
     typedef ICFGEdgeWrapper::ICFGEdgeWrapperSetTy ICFGEdgeWrapperSetTy;
     typedef ICFGEdgeWrapper::ICFGEdgeWrapperSetTy::iterator iterator;
@@ -98,6 +103,7 @@ private:
     ICFGNodeWrapper *_retICFGNodeWrapper{nullptr};
     ICFGEdgeWrapperSetTy InEdges; ///< all incoming edge of this node
     ICFGEdgeWrapperSetTy OutEdges; ///< all outgoing edge of this node
+    bool _materialized{true}; ///< false for a stub whose function is not materialized yet (-lazy-wrapper)
 public:
     ICFGNodeWrapper(const ICFGNode *node) : GenericICFGNodeWrapperTy(node->getId(), 0), _icfgNode(node) {}
 
@@ -139,6 +145,11 @@ public:
         _retICFGNodeWrapper = node;
     }
 
+    /// A stub only holds the edges from/to materialized functions (-lazy-wrapper)
+    inline bool isMaterialized() const {
+        return _materialized;
+    }
+
 
     /// Get incoming/outgoing edge set
     ///@{
@@ -285,6 +296,7 @@ public:
     bool _validCS{true};
     bool _inFSM{true};
     bool _isSrcOrSnk{false};
+    std::vector<const ICFGNode *> _blockMembers; ///< nodes after this one in its super-node, in order (-block-wrapper)
     Set<PIState::DataFact> _tdReachableDataFacts;
     Set<PIState::DataFact> _buReachableDataFacts;
 };
@@ -303,8 +315,15 @@ public:
     typedef std::vector<std::pair<const ICFGNodeWrapper *, const ICFGNodeWrapper *>> ICFGNodeWrapperPairVector;
     typedef Map<const SVFFunction *, const ICFGNodeWrapper *> SVFFuncToICFGNodeWrapperMap;
     typedef SymState::KeyNodes KeyNodes;
+    typedef Map<const SVFFunction *, std::vector<const ICFGNode *>> FunToICFGNodesMap;
 private:
     static std::unique_ptr<ICFGWrapper> _icfgWrapper; ///< Singleton pattern here
+    static FunToICFGNodesMap _funToICFGNodes;         ///< ICFG nodes of each function, built once (-lazy-wrapper)
+    static u32_t _peakNodeWrapperNum;                 ///< max node num of all the wrappers built
+    static u32_t _materializedFunNum;                 ///< functions materialized by all the lazy wrappers
+    bool _lazy{false};
+    bool _tSliceAnnotated{false}; ///< nodes materialized after annotating N_t are not in it
+    Set<const SVFFunction *> _materializedFuns;
     SVFFuncToICFGNodeWrapperMap _funcToFunEntry;
     SVFFuncToICFGNodeWrapperMap _funcToFunExit;
     u32_t _edgeWrapperNum;        ///< total num of node
@@ -341,7 +360,7 @@ public:
     /// Destructor
     virtual ~ICFGWrapper() = default;
 
-    /// Get a ICFG node wrapper
+    /// Get a ICFG node wrapper, nullptr if the node is not in the wrapper
     inline ICFGNodeWrapper *getICFGNodeWrapper(NodeID id) const {
         if (!hasICFGNodeWrapper(id))
             return nullptr;
@@ -411,12 +430,12 @@ public:
         _edgeWrapperNum--;
     }
 
-    /// Remove a ICFGNodeWrapper
+    /// Remove a ICFGNodeWrapper (a stub is removed without materializing its function)
     inline void removeICFGNodeWrapper(ICFGNodeWrapper *node) {
         std::set<ICFGEdgeWrapper *> temp;
-        for (ICFGEdgeWrapper *e: node->getInEdges())
+        for (ICFGEdgeWrapper *e: node->InEdges)
             temp.insert(e);
-        for (ICFGEdgeWrapper *e: node->getOutEdges())
+        for (ICFGEdgeWrapper *e: node->OutEdges)
             temp.insert(e);
         for (ICFGEdgeWrapper *e: temp) {
             removeICFGEdgeWrapper(e);
@@ -447,40 +466,103 @@ public:
     virtual inline void addICFGNodeWrapper(ICFGNodeWrapper *node) {
         addGNode(node->getId(), node);
         _nodeWrapperNum++;
+        if (_nodeWrapperNum > _peakNodeWrapperNum) _peakNodeWrapperNum = _nodeWrapperNum;
+        const SVFFunction *fun = node->getICFGNode()->getFun();
+        node->_materialized = !_lazy || !fun || _materializedFuns.count(fun);
+        if (_tSliceAnnotated) node->_inTSlice = false;
     }
 
+    /// Get the entry/exit of func, nullptr if a lazy wrapper has not materialized func
+    //@{
     const ICFGNodeWrapper *getFunEntry(const SVFFunction *func) const {
         auto it = _funcToFunEntry.find(func);
-        assert(it != _funcToFunEntry.end() && "no entry?");
-        return it->second;
+        assert((_lazy || it != _funcToFunEntry.end()) && "no entry?");
+        return it == _funcToFunEntry.end() ? nullptr : it->second;
     }
 
     const ICFGNodeWrapper *getFunExit(const SVFFunction *func) const {
         auto it = _funcToFunExit.find(func);
-        assert(it != _funcToFunExit.end() && "no exit?");
-        return it->second;
+        assert((_lazy || it != _funcToFunExit.end()) && "no exit?");
+        return it == _funcToFunExit.end() ? nullptr : it->second;
+    }
+    //@}
+
+    /// Whether node id is in N_t, a node a lazy wrapper has not cloned is in it until N_t is annotated
+    inline bool isInTemporalSlice(NodeID id) const {
+        if (const ICFGNodeWrapper *node = getICFGNodeWrapper(id))
+            return node->_inTSlice;
+        return !_tSliceAnnotated;
+    }
+
+    /// Lazy materialization (-lazy-wrapper)
+    ///
+    /// Accessors never materialize, each phase materializes what it traverses
+    /// before traversing it, so no edge set changes while it is iterated
+    //@{
+    inline void setLazy(bool lazy) {
+        _lazy = lazy;
+    }
+
+    inline bool isLazy() const {
+        return _lazy;
+    }
+
+    /// Clone the nodes of fun, their out edges and the interprocedural edges into them
+    void materializeFunction(const SVFFunction *fun);
+
+    /// Materialize the function of a stub node
+    //@{
+    inline void materializeNode(const ICFGNodeWrapper *node) {
+        if (_lazy && !node->isMaterialized())
+            materializeFunction(node->getICFGNode()->getFun());
+    }
+
+    inline void materializeNode(NodeID id) {
+        if (!_lazy) return;
+        const ICFGNodeWrapper *node = getICFGNodeWrapper(id);
+        if (!node || !node->isMaterialized())
+            materializeFunction(_icfg->getICFGNode(id)->getFun());
+    }
+    //@}
+
+    /// Materialize the functions of the nodes reachable from roots, along out edges (forward) or in edges
+    void materializeReachable(const ICFGNodeWrapperVector &roots, bool forward);
+
+    /// Materialize the functions of all the stubs until no stub is left
+    void materializeAll();
+
+    /// Remove the stubs left and stop materializing, e.g., before compacting the graph
+    void freeze();
+
+    static inline u32_t getPeakNodeWrapperNum() {
+        return _peakNodeWrapperNum;
     }
 
+    static inline u32_t getMaterializedFunNum() {
+        return _materializedFunNum;
+    }
+    //@}
+
     /// Add ICFGEdgeWrappers from nodeid pair
     void addICFGNodeWrapperFromICFGNode(const ICFGNode *src);
 
     /// Set in N_t flag based on temporal slice
-    void annotateTemporalSlice(Set<u32_t> &N_t);
+    void annotateTemporalSlice(DenseNodeSet &N_t);
 
     /// Annotate node on FSM
     void annotateFSMNodes(Set<u32_t> &N);
 
     /// Set in N_s flag based on spatial slice
-    void annotateSpatialSlice(Set<u32_t> &N_s);
+    void annotateSpatialSlice(DenseNodeSet &N_s);
 
     /// Set valid callsites
-    void annotateCallsites(Set<u32_t> &N_c);
+    void annotateCallsites(DenseNodeSet &N_c);
 
     /// Remove filled color when dumping dot
     void removeFilledColor();
 
     /// Set in N_t, N_s and callSites flag for reporting bug
-    void annotateMulSlice(Set<u32_t> &N_t, Set<u32_t> &N_s, Set<u32_t> &callSites, const KeyNodes &keyNodes);
+    void annotateMulSlice(DenseNodeSet &N_t, DenseNodeSet &N_s, DenseNodeSet &callSites, const KeyNodes &keyNodes);
 
     inline u32_t getNodeWrapperNum() const {
         return _nodeWrapperNum;
@@ -499,6 +581,13 @@ public:
     ~ICFGWrapperBuilder() {}
 
     void build(ICFG *icfg);
+
+    /// Only materialize demandFuns (and main), other functions are materialized on first access
+    void buildLazy(ICFG *icfg, const Set<const SVFFunction *> &demandFuns);
+
+    /// Functions on call chains from main to src, reachable from curEvalFuns or holding key nodes
+    static void collectDemandFuns(const ICFGNode *src, const Set<const SVFFunction *> &curEvalFuns,
+                                  const Set<NodeID> &keyNodes, Set<const SVFFunction *> &demandFuns);
 };
 }
 
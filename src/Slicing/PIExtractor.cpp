@@ -17,6 +17,13 @@ void PIExtractor::collectKeptNodes(Set<u32_t> &kept) {
     ICFG *icfg = PAG::getPAG()->getICFG();
     FIFOWorkList<u32_t> workList;
     Set<u32_t> visited;
+    // a lazy wrapper has no entry/exit for functions main does not reach
+    auto keepEntryExit = [&](const SVFFunction *fun) {
+        if (const ICFGNodeWrapper *entry = getICFGWrapper()->getFunEntry(fun))
+            kept.insert(entry->getId());
+        if (const ICFGNodeWrapper *exit = getICFGWrapper()->getFunExit(fun))
+            kept.insert(exit->getId());
+    };
     for (const auto &item: getAbsTransitionHandler()->getICFGAbsTransferMap()) {
         kept.insert(item.first->getId());
         if (const CallICFGNode *callNode = SVFUtil::dyn_cast<CallICFGNode>(item.first)) {
@@ -26,8 +33,7 @@ void PIExtractor::collectKeptNodes(Set<u32_t> &kept) {
         if (!visited.count(callgraphNode->getId())) {
             workList.push(callgraphNode->getId());
             visited.insert(callgraphNode->getId());
-            kept.insert(getICFGWrapper()->getFunEntry(item.first->getFun())->getId());
-            kept.insert(getICFGWrapper()->getFunExit(item.first->getFun())->getId());
+            keepEntryExit(item.first->getFun());
         }
     }
     while (!workList.empty()) {
@@ -39,8 +45,7 @@ void PIExtractor::collectKeptNodes(Set<u32_t> &kept) {
             kept.insert(callSite->getRetICFGNode()->getId());
             if (visited.count(e->getSrcID())) continue;
             visited.insert(e->getSrcID());
-            kept.insert(getICFGWrapper()->getFunEntry(callSite->getFun())->getId());
-            kept.insert(getICFGWrapper()->getFunExit(callSite->getFun())->getId());
+            keepEntryExit(callSite->getFun());
             workList.push(e->getSrcID());
         }
     }
@@ -52,7 +57,7 @@ void PIExtractor::compactICFGWrapper() {
     collectKeptNodes(kept);
     Set<ICFGNodeWrapper *> callNodesToCompact, intraNodesToCompact;
     for (const auto &item: *getICFGWrapper()) {
-        if (kept.count(item.second->getId())) continue;
+        if (kept.count(item.second->getId()) || !item.second->isMaterialized()) continue;
         if (SVFUtil::isa<CallICFGNode>(item.second->getICFGNode())) {
             callNodesToCompact.insert(item.second);
         } else if (SVFUtil::isa<IntraICFGNode>(item.second->getICFGNode())) {
@@ -81,9 +86,11 @@ void PIExtractor::initialize(SVFModule *svfModule) {
             }
         }
     }
-    compactICFGWrapper();
     _mainEntry = getICFGWrapper()->getFunEntry(getAbsTransitionHandler()->getMainFunc());
     assert(_mainEntry && "no main function?");
+    // the solver only traverses from main entry, materialize before compacting
+    getICFGWrapper()->materializeReachable({_mainEntry}, true);
+    compactICFGWrapper();
 }
 
 
@@ -250,6 +257,8 @@ PIExtractor::extract(SVFModule *svfModule, const SVFGNode *src, PI &sQ, Set<FSMP
 void PIExtractor::collectPI(PI &seqs, OrderedSet<const ICFGNode *> &sks, const ICFGNode *curEvalICFGNode) {
     for (const auto &node: sks) {
         const ICFGNodeWrapper *evalNode = getICFGWrapper()->getICFGNodeWrapper(node->getId());
+        // snk not reachable
+        if (!evalNode) continue;
         if (const CallICFGNode *callNode = dyn_cast<CallICFGNode>(node)) {
             evalNode = evalNode->getRetICFGNodeWrapper();
         }
@@ -10,6 +10,7 @@
 #include "SVF-LLVM/LLVMUtil.h"
 #include "Slicing/PIState.h"
 #include "Slicing/ICFGWrapper.h"
+#include "PSTA/DedupWorkList.h"
 #include "SVF-LLVM/LLVMModule.h"
 
 /*!
@@ -232,7 +233,7 @@ public:
     typedef Map<const SVFGNode *, PI> SrcToPI;
     typedef FSMHandler::SrcSet SrcSet;
     typedef FSMHandler::ICFGNodeSet ICFGNodeSet;
-    typedef Set<u32_t> NodeIDSet;
+    typedef DenseNodeSet NodeIDSet;
     typedef Map<const SVFGNode *, NodeIDSet> SrcToNodeIDSetMap;
     typedef std::pair<const SVFFunction *, TypeState> SummaryKey;
     typedef PIStateManager::PIStates PIStates;
@@ -244,7 +245,7 @@ public:
     typedef OrderedMap<TypeState, PIState> AbsToPIState;
     typedef Map<SummaryKey, AbsToPIState> SummaryMap;
 
-    typedef FIFOWorkList<WLItem> WorkList;
+    typedef DedupWorkList<WLItem> WorkList;
 
     enum PC_TYPE {
         UNK_PC = 0,
@@ -147,7 +147,7 @@ PIStateManager::getActionOfICFGNode(const ICFGNode *icfgNode) {
                 }
             }
         }
-        if (intraICFGNode->getFun() == getFSMHandler()->getMainFunc() && intraICFGNode->getInst()->isRetInst()) {
+        if (getFSMHandler()->isMainRetNode(intraICFGNode)) {
             return FSMParser::CK_RET;
         }
         return FSMParser::CK_DUMMY;
@@ -7,6 +7,7 @@
 #include "PSTA/PSAOptions.h"
 #include "SABER/SaberSVFGBuilder.h"
 #include "PSTA/Logger.h"
+#include <thread>
 
 using namespace SVF;
 using namespace SVFUtil;
@@ -38,17 +39,21 @@ void SpatialSlicer::spatialSlicing(const SVFGNode *src, ICFGNodeSet &snks) {
         AndersenWaveDiff *ander = AndersenWaveDiff::createAndersenWaveDiff(pag);
         _svfg = _svfgBuilder.buildFullSVFG(ander);
         if (PSAOptions::CxtSensitiveSpatialSlicing()) getAbsTransitionHandler()->buildOutToIns(_svfg);
+        _svfgAdjacency.init(_svfg);
+        DenseIDMap::getSVFGIDMap().build(_svfg);
     }
-    Set<u32_t> branch;
+    // backward traversal: in edges, plus the actual out -> actual ins jumps when they exist
+    _svfgAdjacency.buildInEdges();
+    if (PSAOptions::CxtSensitiveSpatialSlicing())
+        _svfgAdjacency.packOutToIns(getAbsTransitionHandler()->getOutToIns());
     Set<CxtDPItem> visitedCallGDPItems;
     Set<CxtDPItem> visitedCallSites;
-    Set<u32_t> globalVars;
-    Set<u32_t> visitedVFNodes;
+    NodeIDSet visitedVFNodes(DenseIDMap::getSVFGIDMap());
     auto &icfgTransferFunc = const_cast<ICFGAbsTransitionFunc &>(getAbsTransitionHandler()->getICFGAbsTransferMap());
     if (PSAOptions::MultiSlicing() && PSAOptions::EnableTemporalSlicing())
         getICFGWrapper()->annotateTemporalSlice(_temporalSlice);
     std::vector<CxtDPItem> workListLayer;
-    Set<u32_t> visited;
+    NodeIDSet visited(DenseIDMap::getSVFGIDMap());
     ContextCond cxt;
     if (!PSAOptions::SSlicingNorm() && PSAOptions::MultiSlicing()) {
         for (const auto &df: _sQ) {
@@ -78,19 +83,37 @@ void SpatialSlicer::spatialSlicing(const SVFGNode *src, ICFGNodeSet &snks) {
         initLayerAndNs(workListLayer, icfgTransferFunc, snks);
     }
     visitedCallGDPItems.insert(_cGDpItems.begin(), _cGDpItems.end());
+    // closures skip the per-src temporal slice, so they are only valid without it
+    _useClosure = PSAOptions::DepClosure() &&
+                  !(PSAOptions::MultiSlicing() && PSAOptions::EnableTemporalSlicing());
+    _closureEntries.clear();
     int layerNum = PSAOptions::LayerNum();
     while (!workListLayer.empty() && (PSAOptions::LayerNum() == 0 || layerNum-- > 0)) {
         std::vector<CxtDPItem> nxtWorkListLayer;
-        for (const auto &curNode: workListLayer) {
-            u32_t curNodeID = curNode.getCurNodeID();
-            _curSVFGNode = _svfg->getSVFGNode(curNodeID);
-            NodeID cfNodeID = _curSVFGNode->getICFGNode()->getId();
-            _curICFGNode = getICFGWrapper()->getICFGNodeWrapper(cfNodeID);
-            controlSlicing(curNode, nxtWorkListLayer, visitedVFNodes, visitedCallSites, visited);
-            extCallSlicing(curNode, nxtWorkListLayer, visitedVFNodes, visited);
-//            gepSlicing(curNode, nxtWorkListLayer, visitedVFNodes, visited);
-            if (!PSAOptions::EnableDataSlicing()) continue;
-            dataSlicing(curNode, nxtWorkListLayer, visitedVFNodes, visitedCallGDPItems, visited);
+        if (_useClosure) warmClosures(workListLayer);
+        // expanding an item reads the wrapper node of its ICFG node
+        if (getICFGWrapper()->isLazy()) {
+            for (const auto &curNode: workListLayer) {
+                const SVFGNode *curSVFGNode = _svfg->getSVFGNode(curNode.getCurNodeID());
+                getICFGWrapper()->materializeNode(curSVFGNode->getICFGNode()->getId());
+            }
+        }
+        if (PSAOptions::SSlicingThreads() > 1) {
+            // expand in parallel, apply in layer order
+            std::vector<SliceActions> layerActions;
+            expandLayer(workListLayer, layerActions);
+            for (u32_t i = 0; i < workListLayer.size(); ++i) {
+                applyActions(workListLayer[i], layerActions[i], nxtWorkListLayer, visitedVFNodes, visitedCallSites,
+                             visitedCallGDPItems, visited);
+            }
+        } else {
+            SliceActions actions;
+            for (const auto &curNode: workListLayer) {
+                actions.clear();
+                expandItem(curNode, actions);
+                applyActions(curNode, actions, nxtWorkListLayer, visitedVFNodes, visitedCallSites,
+                             visitedCallGDPItems, visited);
+            }
         }
         workListLayer = SVFUtil::move(nxtWorkListLayer);
     }
@@ -121,7 +144,7 @@ void SpatialSlicer::initLayerAndNs(std::vector<CxtDPItem> &workListLayer, ICFGAb
                         // snk point
                         if (snks.count(mpItem.first)) {
                             if (!PSAOptions::EnableTemporalSlicing() ||
-                                getICFGWrapper()->getICFGNodeWrapper(mpItem.first->getId())->_inTSlice) {
+                                getICFGWrapper()->isInTemporalSlice(mpItem.first->getId())) {
                                 for (const auto &vfNode: mpItem.first->getVFGNodes()) {
                                     if(SVFUtil::isa<MSSAPHISVFGNode>(vfNode)) continue;
                                     if (_svfg->hasSVFGNode(vfNode->getId()))
@@ -138,7 +161,7 @@ void SpatialSlicer::initLayerAndNs(std::vector<CxtDPItem> &workListLayer, ICFGAb
                         }
                     } else {
                         if (!PSAOptions::EnableTemporalSlicing() ||
-                            getICFGWrapper()->getICFGNodeWrapper(mpItem.first->getId())->_inTSlice) {
+                            getICFGWrapper()->isInTemporalSlice(mpItem.first->getId())) {
                             // non-snk point
                             for (const auto &vfNode: mpItem.first->getVFGNodes()) {
                                 if(SVFUtil::isa<MSSAPHISVFGNode>(vfNode)) continue;
@@ -156,7 +179,7 @@ void SpatialSlicer::initLayerAndNs(std::vector<CxtDPItem> &workListLayer, ICFGAb
 
                 } else {
                     if (!PSAOptions::EnableTemporalSlicing() ||
-                        getICFGWrapper()->getICFGNodeWrapper(mpItem.first->getId())->_inTSlice) {
+                        getICFGWrapper()->isInTemporalSlice(mpItem.first->getId())) {
                         // no wrapper && Not intra node
                         for (const auto &vfNode: mpItem.first->getVFGNodes()) {
                             if(SVFUtil::isa<MSSAPHISVFGNode>(vfNode)) continue;
@@ -173,7 +196,7 @@ void SpatialSlicer::initLayerAndNs(std::vector<CxtDPItem> &workListLayer, ICFGAb
                 }
             } else {
                 if (!PSAOptions::EnableTemporalSlicing() ||
-                    getICFGWrapper()->getICFGNodeWrapper(mpItem.first->getId())->_inTSlice) {
+                    getICFGWrapper()->isInTemporalSlice(mpItem.first->getId())) {
                     if (const CallICFGNode *callBlockNode = SVFUtil::dyn_cast<CallICFGNode>(
                             mpItem.first)) {
                         Set<const SVFFunction *> functionSet;
@@ -210,7 +233,7 @@ void SpatialSlicer::initLayerAndNs(std::vector<CxtDPItem> &workListLayer, ICFGAb
             }
         } else {
             if (!PSAOptions::EnableTemporalSlicing() ||
-                getICFGWrapper()->getICFGNodeWrapper(mpItem.first->getId())->_inTSlice) {
+                getICFGWrapper()->isInTemporalSlice(mpItem.first->getId())) {
                 // no snkMap
                 for (const auto &vfNode: mpItem.first->getVFGNodes()) {
                     if(SVFUtil::isa<MSSAPHISVFGNode>(vfNode)) continue;
@@ -234,7 +257,7 @@ void SpatialSlicer::initLayerAndNs(std::vector<CxtDPItem> &workListLayer, ICFGAb
  * @param globVars
  * @param visitedVFNodes
  */
-void SpatialSlicer::extractGlobVars(const SVFGNode *node, Set<u32_t> &globVars, Set<u32_t> &visitedVFNodes) {
+void SpatialSlicer::extractGlobVars(const SVFGNode *node, Set<u32_t> &globVars, NodeIDSet &visitedVFNodes) {
     if (!isa<GlobalICFGNode>(node->getICFGNode())) return;
     if (visitedVFNodes.count(node->getId())) return;
     visitedVFNodes.insert(node->getId());
@@ -246,69 +269,166 @@ void SpatialSlicer::extractGlobVars(const SVFGNode *node, Set<u32_t> &globVars,
     }
 }
 
-void SpatialSlicer::controlSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
-                                   Set<u32_t> &visitedVFNodes, Set<CxtDPItem> &visitedCallSites,
-                                   Set<u32_t> &visited) {
-    ControlDG *controlDG = ControlDG::getControlDG();
-    if (const ControlDGNode *cdNode = controlDG->getControlDGNode(_curICFGNode->getId())) {
-        for (const auto &e: cdNode->getInEdges()) {
-            if (e->getSrcNode()->getICFGNode()->getSVFStmts().empty()) continue;
-            if (const BranchStmt *branchStmt = dyn_cast<BranchStmt>(
-                    *e->getSrcNode()->getICFGNode()->getSVFStmts().begin())) {
-                _spatialSlice.insert(e->getSrcNode()->getId());
-                const SVFGNode *vfNode = _svfg->getDefSVFGNode(branchStmt->getCondition());
-                NodeID nodeId = vfNode->getId();
-                if (!PSAOptions::EnableTemporalSlicing() ||
-                    getICFGWrapper()->getICFGNodeWrapper(vfNode->getICFGNode()->getId())->_inTSlice) {
-                    CxtDPItem item(nodeId, curNode.getContexts());
-                    extractGlobVars(vfNode, _globVars, visitedVFNodes);
-                    if (visited.find(item.getCurNodeID()) == visited.end()) {
-                        visited.insert(item.getCurNodeID());
-                        _spatialSlice.insert(vfNode->getICFGNode()->getId());
-                        tmpLayer.push_back(SVFUtil::move(item));
-                    }
+/*!
+ * Expand a layer item into control, external call and data dependence actions
+ * @param curNode
+ * @param actions
+ */
+void SpatialSlicer::expandItem(const CxtDPItem &curNode, SliceActions &actions) {
+    const SVFGNode *curSVFGNode = _svfg->getSVFGNode(curNode.getCurNodeID());
+    const ICFGNodeWrapper *curICFGNode = getICFGWrapper()->getICFGNodeWrapper(curSVFGNode->getICFGNode()->getId());
+    controlSlicing(curNode, curICFGNode, actions);
+    extCallSlicing(curNode, curICFGNode, actions);
+//    gepSlicing(curNode, curICFGNode, actions);
+    if (!PSAOptions::EnableDataSlicing()) return;
+    dataSlicing(curNode, curSVFGNode, curICFGNode, actions);
+}
+
+/*!
+ * Expand the items of a layer on SSlicingThreads threads
+ *
+ * Each thread expands a contiguous chunk of the layer into its own action buffers
+ * @param workListLayer
+ * @param layerActions actions of each item, in layer order
+ */
+void SpatialSlicer::expandLayer(const std::vector<CxtDPItem> &workListLayer,
+                                std::vector<SliceActions> &layerActions) {
+    layerActions.resize(workListLayer.size());
+    u32_t threadNum = std::min<u32_t>(PSAOptions::SSlicingThreads(), workListLayer.size());
+    u32_t chunk = (workListLayer.size() + threadNum - 1) / threadNum;
+    // the threads may look ids up in both maps, but never append to them
+    DenseIDMap::getICFGIDMap().setFrozen(true);
+    DenseIDMap::getSVFGIDMap().setFrozen(true);
+    std::vector<std::thread> threads;
+    for (u32_t t = 0; t < threadNum; ++t) {
+        u32_t begin = t * chunk, end = std::min<u32_t>(begin + chunk, workListLayer.size());
+        threads.emplace_back([this, &workListLayer, &layerActions, begin, end]() {
+            for (u32_t i = begin; i < end; ++i)
+                expandItem(workListLayer[i], layerActions[i]);
+        });
+    }
+    for (auto &thread: threads)
+        thread.join();
+    DenseIDMap::getICFGIDMap().setFrozen(false);
+    DenseIDMap::getSVFGIDMap().setFrozen(false);
+}
+
+/*!
+ * Apply the actions of a layer item to the slices and visited sets
+ * @param curNode
+ * @param actions
+ * @param tmpLayer next layer
+ */
+void SpatialSlicer::applyActions(const CxtDPItem &curNode, const SliceActions &actions,
+                                 std::vector<CxtDPItem> &tmpLayer, NodeIDSet &visitedVFNodes,
+                                 Set<CxtDPItem> &visitedCallSites, Set<CxtDPItem> &visitedCallGDPItems,
+                                 NodeIDSet &visited) {
+    for (const auto &action: actions) {
+        switch (action.kind) {
+            case SliceAction::SliceNode:
+                _spatialSlice.insert(action.id);
+                break;
+            case SliceAction::GlobVars:
+                extractGlobVars(action.vfNode, _globVars, visitedVFNodes);
+                break;
+            case SliceAction::Candidate:
+                applyCandidate(action, tmpLayer, visitedVFNodes, visitedCallGDPItems, visited);
+                break;
+            case SliceAction::ClosureCandidate:
+                if (applyCandidate(action, tmpLayer, visitedVFNodes, visitedCallGDPItems, visited))
+                    _closureEntries[action.item.getCurNodeID()] = std::make_pair(action.closure, action.closureEntry);
+                break;
+            case SliceAction::CallGItem:
+                if (!visitedCallGDPItems.count(action.item)) {
+                    visitedCallGDPItems.insert(action.item);
+                    _cGDpItems.insert(action.item);
                 }
-            } // end branch data slicing
+                break;
+            case SliceAction::Callsites:
+                callsitesControlSlicing(curNode, tmpLayer, visitedVFNodes, visitedCallSites, visited);
+                break;
+        }
+    }
+}
+
+bool SpatialSlicer::applyCandidate(const SliceAction &action, std::vector<CxtDPItem> &tmpLayer,
+                                   NodeIDSet &visitedVFNodes, Set<CxtDPItem> &visitedCallGDPItems,
+                                   NodeIDSet &visited) {
+    extractGlobVars(action.vfNode, _globVars, visitedVFNodes);
+    if (!visited.insert(action.item.getCurNodeID())) return false;
+    _spatialSlice.insert(action.id);
+    if (action.callGraphId != UINT32_MAX) {
+        CxtDPItem item(action.callGraphId, action.item.getContexts());
+        if (!visitedCallGDPItems.count(item)) {
+            visitedCallGDPItems.insert(item);
+            _cGDpItems.insert(SVFUtil::move(item));
+        }
+    }
+    tmpLayer.push_back(action.item);
+    return true;
+}
+
+void SpatialSlicer::controlSlicing(const CxtDPItem &curNode, const ICFGNodeWrapper *curICFGNode,
+                                   SliceActions &actions) {
+    ControlDeps localDeps;
+    const ControlDeps *deps = _useClosure ? findControlDeps(curICFGNode->getId()) : nullptr;
+    if (!deps) {
+        collectControlDeps(curICFGNode->getId(), localDeps);
+        deps = &localDeps;
+    }
+    for (const auto &dep: *deps) {
+        addSliceNode(actions, dep.first);
+        const SVFGNode *vfNode = dep.second;
+        NodeID nodeId = vfNode->getId();
+        if (!PSAOptions::EnableTemporalSlicing() ||
+            getICFGWrapper()->isInTemporalSlice(vfNode->getICFGNode()->getId())) {
+            addCandidate(actions, vfNode->getICFGNode()->getId(), vfNode,
+                         CxtDPItem(nodeId, curNode.getContexts()));
         }
     } // end control slicing
+    // callsites depend on the call graph items collected so far
+    addCallsites(actions);
+}
 
-    Set<u32_t> callSites;
+void SpatialSlicer::callsitesControlSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
+                                            NodeIDSet &visitedVFNodes, Set<CxtDPItem> &visitedCallSites,
+                                            NodeIDSet &visited) {
+    NodeIDSet callSites;
     callsitesExtraction(_cGDpItems, callSites, visitedCallSites);
     _cGDpItems.clear();
+    ControlDeps localDeps;
     for (const auto &id: callSites) {
         if (_callsites.count(id)) continue;
         _callsites.insert(id);
-        if (const ControlDGNode *cdNode = controlDG->getControlDGNode(id)) {
-            for (const auto &e: cdNode->getInEdges()) {
-                if (e->getSrcNode()->getICFGNode()->getSVFStmts().empty()) continue;
-                if (const BranchStmt *branchStmt = dyn_cast<BranchStmt>(
-                        *e->getSrcNode()->getICFGNode()->getSVFStmts().begin())) {
-                    _spatialSlice.insert(e->getSrcNode()->getId());
-                    const SVFGNode *vfNode = _svfg->getDefSVFGNode(branchStmt->getCondition());
-                    NodeID nodeId = vfNode->getId();
-                    if (!PSAOptions::EnableTemporalSlicing() ||
-                        getICFGWrapper()->getICFGNodeWrapper(vfNode->getICFGNode()->getId())->_inTSlice) {
-                        CxtDPItem item(nodeId, curNode.getContexts());
-                        extractGlobVars(vfNode, _globVars, visitedVFNodes);
-                        if (visited.find(item.getCurNodeID()) == visited.end()) {
-                            visited.insert(item.getCurNodeID());
-                            _spatialSlice.insert(vfNode->getICFGNode()->getId());
-                            tmpLayer.push_back(SVFUtil::move(item));
-                        }
-                    }
-                } // end branch data slicing
+        const ControlDeps *deps = _useClosure ? getOrBuildControlDeps(id) : nullptr;
+        if (!deps) {
+            localDeps.clear();
+            collectControlDeps(id, localDeps);
+            deps = &localDeps;
+        }
+        for (const auto &dep: *deps) {
+            _spatialSlice.insert(dep.first);
+            const SVFGNode *vfNode = dep.second;
+            NodeID nodeId = vfNode->getId();
+            if (!PSAOptions::EnableTemporalSlicing() ||
+                getICFGWrapper()->isInTemporalSlice(vfNode->getICFGNode()->getId())) {
+                CxtDPItem item(nodeId, curNode.getContexts());
+                extractGlobVars(vfNode, _globVars, visitedVFNodes);
+                if (!visited.count(item.getCurNodeID())) {
+                    visited.insert(item.getCurNodeID());
+                    _spatialSlice.insert(vfNode->getICFGNode()->getId());
+                    tmpLayer.push_back(SVFUtil::move(item));
+                }
             }
         } // end control slicing
     } // end callsites control slicing
 }
 
-void SpatialSlicer::extCallSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
-                                   Set<u32_t> &visitedVFNodes, Set<u32_t> &visited) {
+void SpatialSlicer::extCallSlicing(const CxtDPItem &curNode, const ICFGNodeWrapper *curICFGNode,
+                                   SliceActions &actions) {
     PAG *pag = PAG::getPAG();
-    if (const RetICFGNode *retICFGNode = SVFUtil::dyn_cast<RetICFGNode>(_curICFGNode->getICFGNode())) {
-        if (_spatialSlice.find(retICFGNode->getCallICFGNode()->getId()) == _spatialSlice.end()) {
-            _spatialSlice.insert(retICFGNode->getCallICFGNode()->getId());
-        }
+    if (const RetICFGNode *retICFGNode = SVFUtil::dyn_cast<RetICFGNode>(curICFGNode->getICFGNode())) {
+        addSliceNode(actions, retICFGNode->getCallICFGNode()->getId());
         if (PSAOptions::EnableExtCallSlicing()) {
             const CallICFGNode *callNode = retICFGNode->getCallICFGNode();
             bool isNotCall = SVFUtil::isExtCall(callNode->getCallSite());
@@ -323,31 +443,22 @@ void SpatialSlicer::extCallSlicing(const CxtDPItem &curNode, std::vector<CxtDPIt
             }
             if (isNotCall) {
                 // handle external call
-                NodeID lhsId = pag->getValueNode(callNode->getCallSite());
                 CallSite cs(callNode->getCallSite());
                 for (u32_t i = 0; i < cs.getNumArgOperands(); i++) {
                     const SVFGNode *vfNode = _svfg->getDefSVFGNode(
                             pag->getGNode(pag->getValueNode(cs.getArgOperand(i))));
                     NodeID nodeId = vfNode->getICFGNode()->getId();
                     if (!PSAOptions::EnableTemporalSlicing() ||
-                        getICFGWrapper()->getICFGNodeWrapper(nodeId)->_inTSlice) {
-                        CxtDPItem item(vfNode->getId(), curNode.getContexts());
-                        extractGlobVars(vfNode, _globVars, visitedVFNodes);
-                        if (visited.find(item.getCurNodeID()) == visited.end()) {
-                            visited.insert(item.getCurNodeID());
-                            _spatialSlice.insert(nodeId);
-                            tmpLayer.push_back(SVFUtil::move(item));
-                        }
+                        getICFGWrapper()->isInTemporalSlice(nodeId)) {
+                        addCandidate(actions, nodeId, vfNode, CxtDPItem(vfNode->getId(), curNode.getContexts()));
                     }
                 }
             } // end ext call
         }
     } // end return node
 
-    if (const CallICFGNode *callNode = SVFUtil::dyn_cast<CallICFGNode>(_curICFGNode->getICFGNode())) {
-        if (_spatialSlice.find(callNode->getId()) == _spatialSlice.end()) {
-            _spatialSlice.insert(callNode->getId());
-        }
+    if (const CallICFGNode *callNode = SVFUtil::dyn_cast<CallICFGNode>(curICFGNode->getICFGNode())) {
+        addSliceNode(actions, callNode->getId());
         if (PSAOptions::EnableExtCallSlicing()) {
             bool isNotCall = SVFUtil::isExtCall(callNode->getCallSite());
             Set<const SVFFunction *> functionSet;
@@ -361,21 +472,14 @@ void SpatialSlicer::extCallSlicing(const CxtDPItem &curNode, std::vector<CxtDPIt
             }
             if (isNotCall) {
                 // handle external call
-                NodeID lhsId = pag->getValueNode(callNode->getCallSite());
                 CallSite cs(callNode->getCallSite());
                 for (u32_t i = 0; i < cs.getNumArgOperands(); i++) {
                     const SVFGNode *vfNode = _svfg->getDefSVFGNode(
                             pag->getGNode(pag->getValueNode(cs.getArgOperand(i))));
                     NodeID nodeId = vfNode->getICFGNode()->getId();
                     if (!PSAOptions::EnableTemporalSlicing() ||
-                        getICFGWrapper()->getICFGNodeWrapper(nodeId)->_inTSlice) {
-                        CxtDPItem item(vfNode->getId(), curNode.getContexts());
-                        extractGlobVars(vfNode, _globVars, visitedVFNodes);
-                        if (visited.find(item.getCurNodeID()) == visited.end()) {
-                            visited.insert(item.getCurNodeID());
-                            _spatialSlice.insert(nodeId);
-                            tmpLayer.push_back(SVFUtil::move(item));
-                        }
+                        getICFGWrapper()->isInTemporalSlice(nodeId)) {
+                        addCandidate(actions, nodeId, vfNode, CxtDPItem(vfNode->getId(), curNode.getContexts()));
                     }
 
                 }
@@ -384,10 +488,9 @@ void SpatialSlicer::extCallSlicing(const CxtDPItem &curNode, std::vector<CxtDPIt
     } // end call node
 }
 
-void SpatialSlicer::gepSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
-                               Set<u32_t> &visitedVFNodes, Set<u32_t> &visited) {
-    PAG *pag = PAG::getPAG();
-    ICFGNode::SVFStmtList svfStmtList = _curICFGNode->getICFGNode()->getSVFStmts();
+void SpatialSlicer::gepSlicing(const CxtDPItem &curNode, const ICFGNodeWrapper *curICFGNode,
+                               SliceActions &actions) {
+    ICFGNode::SVFStmtList svfStmtList = curICFGNode->getICFGNode()->getSVFStmts();
     if (!svfStmtList.empty()) {
         const SVFStmt *svfStmt = *svfStmtList.begin();
         if (const GepStmt *gepStmt = dyn_cast<GepStmt>(svfStmt)) {
@@ -400,14 +503,9 @@ void SpatialSlicer::gepSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem>
                     const SVFGNode *gepVFNode = _svfg->getDefSVFGNode(PAG::getPAG()->getGNode(index));
                     NodeID nodeId = gepVFNode->getICFGNode()->getId();
                     if (!PSAOptions::EnableTemporalSlicing() ||
-                        getICFGWrapper()->getICFGNodeWrapper(nodeId)->_inTSlice) {
-                        CxtDPItem item(gepVFNode->getId(), curNode.getContexts());
-                        extractGlobVars(gepVFNode, _globVars, visitedVFNodes);
-                        if (visited.find(item.getCurNodeID()) == visited.end()) {
-                            visited.insert(item.getCurNodeID());
-                            _spatialSlice.insert(nodeId);
-                            tmpLayer.push_back(SVFUtil::move(item));
-                        }
+                        getICFGWrapper()->isInTemporalSlice(nodeId)) {
+                        addCandidate(actions, nodeId, gepVFNode,
+                                     CxtDPItem(gepVFNode->getId(), curNode.getContexts()));
                     }
 
                 }
@@ -416,87 +514,83 @@ void SpatialSlicer::gepSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem>
     } // end special intra node
 }
 
-void SpatialSlicer::dataSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
-                                Set<u32_t> &visitedVFNodes, Set<CxtDPItem> &visitedCallGDPItems,
-                                Set<u32_t> &visited) {
-    PAG *pag = PAG::getPAG();
-    extractGlobVars(_curSVFGNode, _globVars, visitedVFNodes);
+void SpatialSlicer::dataSlicing(const CxtDPItem &curNode, const SVFGNode *curSVFGNode,
+                                const ICFGNodeWrapper *curICFGNode, SliceActions &actions) {
+    addGlobVars(actions, curSVFGNode);
 
-    for (const auto &vEdge: _curSVFGNode->getInEdges()) {
-        VFGNode *srcVFNode = vEdge->getSrcNode();
+    // intra preds come from the memoized closure: a node pushed from a closure continues in it,
+    // any other node starts its own
+    const DataClosure *closure = nullptr;
+    u32_t entryId = 0;
+    if (_useClosure) {
+        auto entryIt = _closureEntries.find(curSVFGNode->getId());
+        if (entryIt != _closureEntries.end()) {
+            closure = entryIt->second.first;
+            entryId = entryIt->second.second;
+        } else {
+            closure = findDataClosure(curSVFGNode->getId());
+        }
+    }
+    bool intraCovered = closure != nullptr;
+    if (closure) {
+        for (const auto &pred: (*closure)[entryId].preds) {
+            const SVFGNode *srcVFNode = (*closure)[pred].node;
+            const ICFGNode *cfNode = srcVFNode->getICFGNode();
+            NodeID callGraphId = UINT32_MAX;
+            if (const SVFFunction *fun = cfNode->getFun())
+                callGraphId = getPTACallGraph()->getCallGraphNode(fun)->getId();
+            addClosureCandidate(actions, cfNode->getId(), srcVFNode,
+                                CxtDPItem(srcVFNode->getId(), curNode.getContexts()), callGraphId, closure, pred);
+        }
+    }
+
+    for (const auto &vEdge: _svfgAdjacency.getInEdges(curSVFGNode)) {
+        if (intraCovered && vEdge.isIntra()) continue;
+        const SVFGNode *srcVFNode = vEdge.node;
         const ICFGNode *srcCFNode = srcVFNode->getICFGNode();
         if (PSAOptions::EnableTemporalSlicing() &&
-            !getICFGWrapper()->getICFGNodeWrapper(srcCFNode->getId())->_inTSlice)
+            !getICFGWrapper()->isInTemporalSlice(srcCFNode->getId()))
             continue;
         CxtDPItem newItem(srcVFNode->getId(), curNode.getContexts());
-        if (vEdge->isRetVFGEdge()) {
-            FSMParser::FSMAction action = getFSMParser()->getTypeFromStr(
-                    vEdge->getSrcNode()->getFun()->getName());
-            if (_curEvalFuns.count(vEdge->getSrcNode()->getFun()) ||
+        if (vEdge.isRet()) {
+            FSMParser::FSMAction action = getFSMParser()->getTypeFromStr(srcVFNode->getFun()->getName());
+            if (_curEvalFuns.count(srcVFNode->getFun()) ||
                 (getFSMParser()->getFSMActions().count(action) && action != FSMParser::CK_DUMMY))
                 continue;
-            CallSiteID csId = 0;
-            if (const RetDirSVFGEdge *retEdge = SVFUtil::dyn_cast<RetDirSVFGEdge>(vEdge))
-                csId = retEdge->getCallSiteId();
-            else
-                csId = SVFUtil::cast<RetIndSVFGEdge>(vEdge)->getCallSiteId();
-            newItem.pushContext(csId);
-        } else if (vEdge->isCallVFGEdge()) {
-            FSMParser::FSMAction action = getFSMParser()->getTypeFromStr(
-                    vEdge->getDstNode()->getFun()->getName());
-            if (_curEvalFuns.count(vEdge->getDstNode()->getFun()) ||
+            newItem.pushContext(vEdge.csId);
+        } else if (vEdge.isCall()) {
+            FSMParser::FSMAction action = getFSMParser()->getTypeFromStr(curSVFGNode->getFun()->getName());
+            if (_curEvalFuns.count(curSVFGNode->getFun()) ||
                 (getFSMParser()->getFSMActions().count(action) && action != FSMParser::CK_DUMMY))
                 continue;
-            CallSiteID csId = 0;
-            if (const CallDirSVFGEdge *callEdge = SVFUtil::dyn_cast<CallDirSVFGEdge>(vEdge))
-                csId = callEdge->getCallSiteId();
-            else
-                csId = SVFUtil::cast<CallIndSVFGEdge>(vEdge)->getCallSiteId();
-
-            if (!newItem.matchContext(csId)) continue;
+            if (!newItem.matchContext(vEdge.csId)) continue;
         }
-        extractGlobVars(srcVFNode, _globVars, visitedVFNodes);
-        /// whether this dstNode has been visited or not
-        if (visited.count(newItem.getCurNodeID())) continue;
-        else visited.insert(newItem.getCurNodeID());
-        _spatialSlice.insert(srcCFNode->getId());
-        if (const SVFFunction *fun = srcCFNode->getFun()) {
-            NodeID callGraphId = getPTACallGraph()->getCallGraphNode(fun)->getId();
-            CxtDPItem item(callGraphId, newItem.getContexts());
-            if (!visitedCallGDPItems.count(item)) {
-                visitedCallGDPItems.insert(item);
-                _cGDpItems.insert(SVFUtil::move(item));
-            }
-        }
-        tmpLayer.push_back(SVFUtil::move(newItem));
+        NodeID callGraphId = UINT32_MAX;
+        if (const SVFFunction *fun = srcCFNode->getFun())
+            callGraphId = getPTACallGraph()->getCallGraphNode(fun)->getId();
+        addCandidate(actions, srcCFNode->getId(), srcVFNode, SVFUtil::move(newItem), callGraphId);
     } // end vfedges
 
-    if (SVFUtil::isa<ActualOUTSVFGNode>(_curSVFGNode) || SVFUtil::isa<ActualRetVFGNode>(_curSVFGNode)) {
-        for (const auto &actualin: getAbsTransitionHandler()->getReachableActualInsOfActualOut(_curSVFGNode)) {
-            if (PSAOptions::EnableTemporalSlicing() &&
-                !getICFGWrapper()->getICFGNodeWrapper(actualin->getICFGNode()->getId())->_inTSlice)
-                continue;
-            CxtDPItem newItem(actualin->getId(), curNode.getContexts());
-            extractGlobVars(actualin, _globVars, visitedVFNodes);
-            if (visited.count(newItem.getCurNodeID())) continue;
-            else visited.insert(newItem.getCurNodeID());
-            _spatialSlice.insert(actualin->getICFGNode()->getId());
-            tmpLayer.push_back(SVFUtil::move(newItem));
+    if (SVFUtil::isa<ActualOUTSVFGNode>(curSVFGNode) || SVFUtil::isa<ActualRetVFGNode>(curSVFGNode)) {
+        if (!intraCovered) {
+            for (const auto &actualin: _svfgAdjacency.getActualInsOfActualOut(curSVFGNode)) {
+                if (PSAOptions::EnableTemporalSlicing() &&
+                    !getICFGWrapper()->isInTemporalSlice(actualin->getICFGNode()->getId()))
+                    continue;
+                addCandidate(actions, actualin->getICFGNode()->getId(), actualin,
+                             CxtDPItem(actualin->getId(), curNode.getContexts()));
+            }
         }
-        if(const RetICFGNode* retNode = SVFUtil::dyn_cast<RetICFGNode>(_curICFGNode->getICFGNode())) {
+        if(const RetICFGNode* retNode = SVFUtil::dyn_cast<RetICFGNode>(curICFGNode->getICFGNode())) {
             const CallICFGNode *callNode = retNode->getCallICFGNode();
             if (PSAOptions::EnableTemporalSlicing() &&
-                !getICFGWrapper()->getICFGNodeWrapper(callNode->getId())->_inTSlice)
+                !getICFGWrapper()->isInTemporalSlice(callNode->getId()))
                 return;
             if (const SVFFunction *fun = SVFUtil::getCallee(callNode->getCallSite())) {
                 NodeID callGraphId = getPTACallGraph()->getCallGraphNode(fun)->getId();
                 ContextCond curContext = curNode.getContexts();
                 curContext.pushContext(getPTACallGraph()->getCallSiteID(callNode, fun));
-                CxtDPItem item(callGraphId, curContext);
-                if (!visitedCallGDPItems.count(item)) {
-                    visitedCallGDPItems.insert(item);
-                    _cGDpItems.insert(SVFUtil::move(item));
-                }
+                addCallGItem(actions, CxtDPItem(callGraphId, curContext));
             }
         }
     }
@@ -506,7 +600,7 @@ void SpatialSlicer::dataSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem>
  * Extract the functions (callgraph nodes) of interest for each src
  * @param srcs
  */
-void SpatialSlicer::callsitesExtraction(Set<CxtDPItem> &cGDpItems, Set<u32_t> &callSites, Set<CxtDPItem> &visited) {
+void SpatialSlicer::callsitesExtraction(Set<CxtDPItem> &cGDpItems, NodeIDSet &callSites, Set<CxtDPItem> &visited) {
     ICFG *icfg = PAG::getPAG()->getICFG();
     FIFOWorkList<CxtDPItem> workList;
     for (const auto &item: cGDpItems) {
@@ -522,7 +616,7 @@ void SpatialSlicer::callsitesExtraction(Set<CxtDPItem> &cGDpItems, Set<u32_t> &c
             if (!newItem.matchContext(e->getCallSiteID())) continue;
             NodeID nodeId = getPTACallGraph()->getCallSite(e->getCallSiteID())->getId();
             if (!PSAOptions::EnableTemporalSlicing() ||
-                getICFGWrapper()->getICFGNodeWrapper(nodeId)->_inTSlice) {
+                getICFGWrapper()->isInTemporalSlice(nodeId)) {
                 callSites.insert(nodeId);
                 if (visited.count(newItem)) continue;
                 else visited.insert(newItem);
@@ -532,3 +626,131 @@ void SpatialSlicer::callsitesExtraction(Set<CxtDPItem> &cGDpItems, Set<u32_t> &c
     }
 }
 
+
+/*!
+ * Build the dependence closures needed by a layer
+ *
+ * Runs before expansion, so (parallel) expansion only looks them up.
+ * An item without a memoized closure is expanded one step at a time
+ * @param workListLayer
+ */
+void SpatialSlicer::warmClosures(const std::vector<CxtDPItem> &workListLayer) {
+    for (const auto &curNode: workListLayer) {
+        const SVFGNode *curSVFGNode = _svfg->getSVFGNode(curNode.getCurNodeID());
+        getOrBuildControlDeps(curSVFGNode->getICFGNode()->getId());
+        if (PSAOptions::EnableDataSlicing() && !_closureEntries.count(curSVFGNode->getId()))
+            getOrBuildDataClosure(curSVFGNode);
+    }
+}
+
+/*!
+ * Intra-procedural backward data closure of node, memoized across sources
+ *
+ * The closure follows intra edges and actual out -> actual in jumps, which keep the
+ * calling context, so it does not depend on the context or on the evaluated source.
+ * Call/ret edges are left to the layered traversal.
+ * A closure is only built when node is queried again (by a later source), a node
+ * queried once is cheaper to expand step by step.
+ * The memos are bounded by PSAOptions::MaxDepClosureNodeNum entries in total (0 means unbounded),
+ * once full no closure is added and memoized ones stay valid.
+ */
+const SpatialSlicer::DataClosure *SpatialSlicer::getOrBuildDataClosure(const SVFGNode *node) {
+    if (const DataClosure *closure = findDataClosure(node->getId())) {
+        _closureHits++;
+        return closure;
+    }
+    _closureMisses++;
+    if (_queriedDataClosures.test_and_set(node->getId()) || _rejectedDataClosures.test(node->getId()) ||
+        !closureFits(1))
+        return nullptr;
+    DataClosure closure;
+    collectDataClosure(node, closure);
+    if (!closureFits(closure.size())) {
+        _rejectedDataClosures.set(node->getId());
+        _closureRejects++;
+        return nullptr;
+    }
+    _closureNodeNum += closure.size();
+    return &(_dataClosures[node->getId()] = SVFUtil::move(closure));
+}
+
+const SpatialSlicer::ControlDeps *SpatialSlicer::getOrBuildControlDeps(NodeID id) {
+    if (const ControlDeps *deps = findControlDeps(id)) {
+        _closureHits++;
+        return deps;
+    }
+    _closureMisses++;
+    if (_queriedControlDeps.test_and_set(id))
+        return nullptr;
+    ControlDeps deps;
+    collectControlDeps(id, deps);
+    // an empty list still takes its slot
+    if (!closureFits(deps.size() + 1)) {
+        _closureRejects++;
+        return nullptr;
+    }
+    _closureNodeNum += deps.size() + 1;
+    return &(_controlDeps[id] = SVFUtil::move(deps));
+}
+
+bool SpatialSlicer::closureFits(u32_t size) const {
+    return PSAOptions::MaxDepClosureNodeNum() == 0 || _closureNodeNum + size <= PSAOptions::MaxDepClosureNodeNum();
+}
+
+/*!
+ * Breadth-first, an entry keeps the preds one step further from node:
+ * a pred at the same or a smaller distance is pushed by then
+ * @param node
+ * @param closure reached nodes, node first
+ */
+void SpatialSlicer::collectDataClosure(const SVFGNode *node, DataClosure &closure) const {
+    std::vector<u32_t> dists;
+    Map<NodeID, u32_t> entryIds;
+    FIFOWorkList<u32_t> workList;
+    auto addPred = [&](u32_t curId, const SVFGNode *srcVFNode) {
+        auto entryIt = entryIds.find(srcVFNode->getId());
+        if (entryIt == entryIds.end()) {
+            u32_t srcId = closure.size();
+            closure.push_back(DataClosureEntry{srcVFNode});
+            dists.push_back(dists[curId] + 1);
+            entryIds[srcVFNode->getId()] = srcId;
+            closure[curId].preds.push_back(srcId);
+            workList.push(srcId);
+        } else if (dists[entryIt->second] == dists[curId] + 1) {
+            closure[curId].preds.push_back(entryIt->second);
+        }
+    };
+    closure.push_back(DataClosureEntry{node});
+    dists.push_back(0);
+    entryIds[node->getId()] = 0;
+    workList.push(0);
+    while (!workList.empty()) {
+        u32_t curId = workList.pop();
+        const SVFGNode *cur = closure[curId].node;
+        for (const auto &vEdge: _svfgAdjacency.getInEdges(cur)) {
+            if (!vEdge.isIntra()) continue;
+            addPred(curId, vEdge.node);
+        }
+        if (!SVFUtil::isa<ActualOUTSVFGNode>(cur) && !SVFUtil::isa<ActualRetVFGNode>(cur)) continue;
+        for (const auto &actualin: _svfgAdjacency.getActualInsOfActualOut(cur))
+            addPred(curId, actualin);
+    }
+}
+
+/*!
+ * Branch nodes id depends on and the definitions of their conditions
+ * @param id ControlDG (ICFG) node id
+ * @param deps
+ */
+void SpatialSlicer::collectControlDeps(NodeID id, ControlDeps &deps) const {
+    ControlDG *controlDG = ControlDG::getControlDG();
+    const ControlDGNode *cdNode = controlDG->getControlDGNode(id);
+    if (!cdNode) return;
+    for (const auto &e: cdNode->getInEdges()) {
+        if (e->getSrcNode()->getICFGNode()->getSVFStmts().empty()) continue;
+        if (const BranchStmt *branchStmt = dyn_cast<BranchStmt>(
+                *e->getSrcNode()->getICFGNode()->getSVFStmts().begin())) {
+            deps.emplace_back(e->getSrcNode()->getId(), _svfg->getDefSVFGNode(branchStmt->getCondition()));
+        }
+    }
+}
@@ -29,6 +29,40 @@ public:
     typedef Map<const SVFGNode *, Set<CxtDPItem>> SrcToCxtDPItemSetMap;
     typedef PIState::DataFact KeyNodes;
 
+    /// A node of a backward data closure
+    struct DataClosureEntry {
+        const SVFGNode *node;
+        std::vector<u32_t> preds; ///< entries one step further from the root, reaching this node
+    };
+    /// Nodes in BFS order from the root (entry 0), keeping only the edges leading one step further
+    typedef std::vector<DataClosureEntry> DataClosure;
+    typedef std::vector<std::pair<NodeID, const SVFGNode *>> ControlDeps; ///< branch nodes and defs of their conditions
+
+    /*!
+     * Effect of expanding one layer item
+     *
+     * Items of a layer are expanded into actions without touching the shared
+     * slices and visited sets, then the actions are applied in layer order
+     */
+    struct SliceAction {
+        enum Kind {
+            SliceNode,  ///< add id to the spatial slice
+            GlobVars,   ///< collect global vars of vfNode
+            Candidate,  ///< if item is not visited: add id to the spatial slice, push item and its call graph item
+            ClosureCandidate, ///< candidate from a memoized closure, if pushed it continues in the closure
+            CallGItem,  ///< add item to the call graph items
+            Callsites   ///< control slicing of the callsites reaching the call graph items so far
+        };
+        Kind kind;
+        NodeID id;
+        const SVFGNode *vfNode;
+        CxtDPItem item;
+        NodeID callGraphId; ///< call graph node of the candidate's function, UINT32_MAX for none
+        const DataClosure *closure; ///< closure of a closure candidate
+        u32_t closureEntry;         ///< entry of a closure candidate in its closure
+    };
+    typedef std::vector<SliceAction> SliceActions;
+
 
 private:
     NodeIDSet &_temporalSlice;       ///< map source object (SVFGNode) to its temporal slice
@@ -37,21 +71,35 @@ private:
     Set<CxtDPItem> &_cGDpItems;
     NodeIDSet &_branch;    ///< map source object (SVFGNode) to the branches needed for analysis
     SQ &_sQ;                  ///< map source object (SVFGNode) to its operation sequences
-    NodeIDSet &_globVars;
+    Set<u32_t> &_globVars;
 
     SVFGBuilder _svfgBuilder;
     SVFG *_svfg;
-
-    ICFGNodeWrapper *_curICFGNode;
-    SVFGNode *_curSVFGNode;
+    SVFGAdjacency _svfgAdjacency; ///< CSR edges and actual out -> actual ins of _svfg
 
     Set<const SVFFunction *> _curEvalFuns;
     const ICFGNode *_curEvalICFGNode{nullptr};
 
+    /// Backward dependences memoized across srcs (-dep-closure)
+    //{%
+    Map<NodeID, DataClosure> _dataClosures;  ///< SVFG node -> its intra-procedural backward data closure
+    Map<NodeID, ControlDeps> _controlDeps;   ///< ControlDG node -> its control dependences
+    NodeBS _queriedDataClosures;             ///< SVFG nodes whose closure has been queried
+    NodeBS _queriedControlDeps;              ///< ControlDG nodes whose control dependences have been queried
+    NodeBS _rejectedDataClosures;            ///< SVFG nodes whose closure does not fit in the memo
+    u32_t _closureNodeNum{0};                ///< total number of entries in _dataClosures and _controlDeps
+    u32_t _closureHits{0};
+    u32_t _closureMisses{0};
+    u32_t _closureRejects{0};
+    bool _useClosure{false};                 ///< closures are valid for the current src
+    /// SVFG node pushed from a closure -> (closure, entry of the node)
+    Map<NodeID, std::pair<const DataClosure *, u32_t>> _closureEntries;
+    //%}
+
 public:
     SpatialSlicer(NodeIDSet &temporalSlice, NodeIDSet &callsites,
                   NodeIDSet &spatialSlice, Set<CxtDPItem> &cGDpItems,
-                  NodeIDSet &branch, SQ &sQ, NodeIDSet &globVars)
+                  NodeIDSet &branch, SQ &sQ, Set<u32_t> &globVars)
             : _temporalSlice(temporalSlice), _callsites(callsites), _spatialSlice(spatialSlice), _cGDpItems(cGDpItems),
               _branch(branch), _sQ(sQ), _globVars(globVars) {}
 
@@ -75,7 +123,7 @@ public:
 
 
     /// Extract dependent vars in global node
-    void extractGlobVars(const SVFGNode *node, Set<u32_t> &globVars, Set<u32_t> &visitedVFNodes);
+    void extractGlobVars(const SVFGNode *node, Set<u32_t> &globVars, NodeIDSet &visitedVFNodes);
 
     /// Multi-point slicing
     //{%
@@ -83,25 +131,126 @@ public:
     void spatialSlicing(const SVFGNode *src, ICFGNodeSet &snks);
     //%}
 
-    void callsitesExtraction(Set<CxtDPItem> &cGDpItems, Set<u32_t> &callSites, Set<CxtDPItem> &visited);
+    void callsitesExtraction(Set<CxtDPItem> &cGDpItems, NodeIDSet &callSites, Set<CxtDPItem> &visited);
+
+    inline const SVFGAdjacency &getSVFGAdjacency() const {
+        return _svfgAdjacency;
+    }
+
+    /// Dependence closure statistics
+    //{%
+    inline u32_t getDepClosureNum() const {
+        return _dataClosures.size() + _controlDeps.size();
+    }
+
+    inline u32_t getDepClosureHitNum() const {
+        return _closureHits;
+    }
+
+    inline u32_t getDepClosureMissNum() const {
+        return _closureMisses;
+    }
+
+    inline u32_t getDepClosureRejectNum() const {
+        return _closureRejects;
+    }
+
+    inline u32_t getDepClosureNodeNum() const {
+        return _closureNodeNum;
+    }
+    //%}
 
 protected:
     void initLayerAndNs(std::vector<CxtDPItem> &workListLayer,
                         ICFGAbsTransitionFunc &icfgTransferFunc, ICFGNodeSet &snks);
 
-    void controlSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
-                        Set<u32_t> &visitedVFNodes, Set<CxtDPItem> &visitedCallSites,
-                        Set<u32_t> &visited);
+    /// Expand a layer item into actions, read only on shared state
+    void expandItem(const CxtDPItem &curNode, SliceActions &actions);
 
-    void extCallSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
-                        Set<u32_t> &visitedVFNodes, Set<u32_t> &visited);
+    /// Expand the items of a layer across SSlicingThreads threads
+    void expandLayer(const std::vector<CxtDPItem> &workListLayer, std::vector<SliceActions> &layerActions);
 
-    void gepSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
-                    Set<u32_t> &visitedVFNodes, Set<u32_t> &visited);
+    /// Apply actions in layer order
+    void applyActions(const CxtDPItem &curNode, const SliceActions &actions, std::vector<CxtDPItem> &tmpLayer,
+                      NodeIDSet &visitedVFNodes, Set<CxtDPItem> &visitedCallSites,
+                      Set<CxtDPItem> &visitedCallGDPItems, NodeIDSet &visited);
 
-    void dataSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
-                     Set<u32_t> &visitedVFNodes, Set<CxtDPItem> &visitedCallGDPItems,
-                     Set<u32_t> &visited);
+    /// Push a candidate not visited yet, return true if pushed
+    bool applyCandidate(const SliceAction &action, std::vector<CxtDPItem> &tmpLayer, NodeIDSet &visitedVFNodes,
+                        Set<CxtDPItem> &visitedCallGDPItems, NodeIDSet &visited);
+
+    /// Memoized dependences
+    //{%
+    /// Build the closures of a layer before expanding it
+    void warmClosures(const std::vector<CxtDPItem> &workListLayer);
+
+    /// Memoized closure of node, nullptr if it is not worth (or cannot be) memoized
+    const DataClosure *getOrBuildDataClosure(const SVFGNode *node);
+
+    const ControlDeps *getOrBuildControlDeps(NodeID id);
+
+    /// Lookup without building, safe for concurrent readers
+    inline const DataClosure *findDataClosure(NodeID id) const {
+        auto it = _dataClosures.find(id);
+        return it == _dataClosures.end() ? nullptr : &it->second;
+    }
+
+    inline const ControlDeps *findControlDeps(NodeID id) const {
+        auto it = _controlDeps.find(id);
+        return it == _controlDeps.end() ? nullptr : &it->second;
+    }
+
+    /// Whether size more entries fit in the memo
+    bool closureFits(u32_t size) const;
+
+    void collectDataClosure(const SVFGNode *node, DataClosure &closure) const;
+
+    void collectControlDeps(NodeID id, ControlDeps &deps) const;
+    //%}
+
+    void controlSlicing(const CxtDPItem &curNode, const ICFGNodeWrapper *curICFGNode, SliceActions &actions);
+
+    void callsitesControlSlicing(const CxtDPItem &curNode, std::vector<CxtDPItem> &tmpLayer,
+                                 NodeIDSet &visitedVFNodes, Set<CxtDPItem> &visitedCallSites,
+                                 NodeIDSet &visited);
+
+    void extCallSlicing(const CxtDPItem &curNode, const ICFGNodeWrapper *curICFGNode, SliceActions &actions);
+
+    void gepSlicing(const CxtDPItem &curNode, const ICFGNodeWrapper *curICFGNode, SliceActions &actions);
+
+    void dataSlicing(const CxtDPItem &curNode, const SVFGNode *curSVFGNode, const ICFGNodeWrapper *curICFGNode,
+                     SliceActions &actions);
+
+    /// Action builders
+    //{%
+    static inline void addSliceNode(SliceActions &actions, NodeID id) {
+        actions.push_back({SliceAction::SliceNode, id, nullptr, CxtDPItem(0, ContextCond()), UINT32_MAX, nullptr, 0});
+    }
+
+    static inline void addGlobVars(SliceActions &actions, const SVFGNode *vfNode) {
+        actions.push_back({SliceAction::GlobVars, 0, vfNode, CxtDPItem(0, ContextCond()), UINT32_MAX, nullptr, 0});
+    }
+
+    static inline void addCandidate(SliceActions &actions, NodeID id, const SVFGNode *vfNode, CxtDPItem &&item,
+                                    NodeID callGraphId = UINT32_MAX) {
+        actions.push_back({SliceAction::Candidate, id, vfNode, SVFUtil::move(item), callGraphId, nullptr, 0});
+    }
+
+    static inline void addClosureCandidate(SliceActions &actions, NodeID id, const SVFGNode *vfNode,
+                                           CxtDPItem &&item, NodeID callGraphId, const DataClosure *closure,
+                                           u32_t closureEntry) {
+        actions.push_back({SliceAction::ClosureCandidate, id, vfNode, SVFUtil::move(item), callGraphId, closure,
+                           closureEntry});
+    }
+
+    static inline void addCallGItem(SliceActions &actions, CxtDPItem &&item) {
+        actions.push_back({SliceAction::CallGItem, 0, nullptr, SVFUtil::move(item), UINT32_MAX, nullptr, 0});
+    }
+
+    static inline void addCallsites(SliceActions &actions) {
+        actions.push_back({SliceAction::Callsites, 0, nullptr, CxtDPItem(0, ContextCond()), UINT32_MAX, nullptr, 0});
+    }
+    //%}
 
 }; // end class SpatialSlicer
 } // end namespace SVF
@@ -5,12 +5,17 @@
 #include "Slicing/TemporalSlicer.h"
 #include "PSTA/PSAOptions.h"
 #include "PSTA/Logger.h"
+#include <atomic>
+#include <thread>
 
 using namespace SVF;
 using namespace SVFUtil;
 
 /*!
  * Temporal slicing
+ *
+ * PIs are independent until their slices are merged, with -tps-threads=N (N > 1)
+ * N threads solve them into local data fact stores
  * @param srcs
  * @param mainEntry
  */
@@ -19,92 +24,174 @@ void TemporalSlicer::temporalSlicing(const SVFGNode *src, const ICFGNodeWrapper
     Dump() << "Temporal slicing...\n";
     Log(LogLevel::Info) << " TPS src: " << std::to_string(src->getICFGNode()->getId()) << "\n";
     Dump() << " TPS src: " << std::to_string(src->getICFGNode()->getId()) << "\n";
-    Set<u32_t> temporalSlice;
+    NodeIDSet temporalSlice;
     Log(LogLevel::Info) << "seqs size: " << std::to_string(_sQ.size()) << "\n";
     Dump() << "seqs size: " << std::to_string(_sQ.size()) << "\n";
 
-    u32_t ct2 = 0;
+    const ICFGNode *curEvalICFGNode = src->getICFGNode();
+    if (const RetICFGNode *retICFGNOde = dyn_cast<RetICFGNode>(curEvalICFGNode)) {
+        curEvalICFGNode = retICFGNOde->getCallICFGNode();
+    }
+    Set<const SVFFunction *> curEvalFuns;
+    for (const auto &e: curEvalICFGNode->getOutEdges()) {
+        if (const CallCFGEdge *callEdge = dyn_cast<CallCFGEdge>(e)) {
+            curEvalFuns.insert(callEdge->getDstNode()->getFun());
+        }
+    }
+    std::vector<const DataFact *> dataFacts;
+    ICFGWrapper::ICFGNodeWrapperVector snks;
     for (const auto &dataFact: _sQ) {
-        ct2++;
-        clearDF();
-        std::vector<DataFact> allDataFacts;
-        DataFact dataFactTmp = dataFact;
-        Set<u32_t> temporalSliceTmp;
-        while (!dataFactTmp.empty()) {
-            allDataFacts.push_back(dataFactTmp);
-            dataFactTmp.pop_back();
+        dataFacts.push_back(&dataFact);
+        snks.push_back(getICFGWrapper()->getICFGNodeWrapper(dataFact.front()));
+    }
+    // a N_t node reaches a snk, the bottom-up solver only traverses (and the top-down solver only
+    // propagates through) the nodes reaching snks, the stubs left never become part of N_t
+    getICFGWrapper()->materializeReachable(snks, false);
+
+    u32_t threadNum = std::min<u32_t>(PSAOptions::TPSThreads(), dataFacts.size());
+    if (threadNum > 1) {
+        // the wrapper is closed under the solvers' traversals above, the threads only read it
+        std::vector<std::vector<NodeID>> slices(dataFacts.size());
+        DataFactStore lastStore(true);
+        std::atomic<u32_t> next{0};
+        std::vector<std::thread> threads;
+        for (u32_t t = 0; t < threadNum; ++t) {
+            threads.emplace_back([&]() {
+                for (u32_t i = next++; i < dataFacts.size(); i = next++) {
+                    DataFactStore store(true);
+                    solvePI(*dataFacts[i], mainEntry, curEvalICFGNode, curEvalFuns, store, slices[i]);
+                    if (i + 1 == dataFacts.size()) lastStore = SVFUtil::move(store);
+                }
+            });
         }
-        // zero data fact
-        allDataFacts.emplace_back();
-        initBUDFTransferFunc(mainEntry, allDataFacts);
-        Log(LogLevel::Info) << std::to_string(ct2) << " ";
-        Dump() << std::to_string(ct2) << " ";
-        const ICFGNode *curEvalICFGNode = src->getICFGNode();
-        if (const RetICFGNode *retICFGNOde = dyn_cast<RetICFGNode>(curEvalICFGNode)) {
-            curEvalICFGNode = retICFGNOde->getCallICFGNode();
+        for (auto &thread: threads)
+            thread.join();
+        // leave the data facts of the last PI on the wrapper, as the sequential loop does
+        clearDF();
+        lastStore.commit();
+        for (u32_t i = 0; i < dataFacts.size(); ++i) {
+            Log(LogLevel::Info) << std::to_string(i + 1) << " ";
+            Dump() << std::to_string(i + 1) << " ";
+            mergeSlice(*dataFacts[i], slices[i], temporalSlice);
         }
-        Set<const SVFFunction *> curEvalFuns;
-        for (const auto &e: curEvalICFGNode->getOutEdges()) {
-            if (const CallCFGEdge *callEdge = dyn_cast<CallCFGEdge>(e)) {
-                curEvalFuns.insert(callEdge->getDstNode()->getFun());
-            }
+    } else {
+        u32_t ct2 = 0;
+        for (const auto &dataFact: dataFacts) {
+            ct2++;
+            clearDF();
+            Log(LogLevel::Info) << std::to_string(ct2) << " ";
+            Dump() << std::to_string(ct2) << " ";
+            DataFactStore store;
+            std::vector<NodeID> slice;
+            solvePI(*dataFact, mainEntry, curEvalICFGNode, curEvalFuns, store, slice);
+            mergeSlice(*dataFact, slice, temporalSlice);
         }
-        buIFDSSolve(mainEntry, getICFGWrapper()->getICFGNodeWrapper(dataFact.front()), curEvalICFGNode, allDataFacts, curEvalFuns);
-//            // early terminate - no seq at entry
-        if ((*mainEntry->getOutEdges().begin())->getDstNode()->_buReachableDataFacts.find(allDataFacts[0]) ==
-            (*mainEntry->getOutEdges().begin())->getDstNode()->_buReachableDataFacts.end())
-            continue;
-        initTDDFTransferFunc(mainEntry, allDataFacts);
-        tdIFDSSolve(mainEntry, curEvalICFGNode, allDataFacts, curEvalFuns);
+    }
+    Log(LogLevel::Info) << SVFUtil::sucMsg("\nTemporal slicing...[done]\n");
+    Dump() << SVFUtil::sucMsg("\nTemporal slicing...[done]\n");
+    _temporalSlice = SVFUtil::move(temporalSlice);
+}
 
-        for (const auto &n: *getICFGWrapper()) {
-            if (!n.second->_tdReachableDataFacts.empty() && !n.second->_buReachableDataFacts.empty()) {
-                for (const auto &df1: n.second->_tdReachableDataFacts) {
-                    // has non-zero intersection datafacts
-                    if (!df1.empty() &&
-                        n.second->_buReachableDataFacts.find(df1) != n.second->_buReachableDataFacts.end()) {
-                        temporalSliceTmp.insert(n.first);
-                        temporalSlice.insert(n.first);
-                    }
+/*!
+ * Solve a PI
+ *
+ * Touches no shared state but the wrapper graph (read only) if store is local
+ * @param dataFact
+ * @param mainEntry
+ * @param curEvalICFGNode
+ * @param curEvalFuns
+ * @param store
+ * @param slice
+ */
+void TemporalSlicer::solvePI(const DataFact &dataFact, const ICFGNodeWrapper *mainEntry,
+                             const ICFGNode *curEvalICFGNode, Set<const SVFFunction *> &curEvalFuns,
+                             DataFactStore &store, std::vector<NodeID> &slice) {
+    std::vector<DataFact> allDataFacts;
+    DataFact dataFactTmp = dataFact;
+    while (!dataFactTmp.empty()) {
+        allDataFacts.push_back(dataFactTmp);
+        dataFactTmp.pop_back();
+    }
+    // zero data fact
+    allDataFacts.emplace_back();
+    initBUDFTransferFunc(mainEntry, allDataFacts, store);
+    buIFDSSolve(mainEntry, getICFGWrapper()->getICFGNodeWrapper(dataFact.front()), curEvalICFGNode, allDataFacts,
+                curEvalFuns, store);
+    // early terminate - no seq at entry
+    if (!store.getBuReachable((*mainEntry->getOutEdges().begin())->getDstNode()).count(allDataFacts[0]))
+        return;
+    initTDDFTransferFunc(mainEntry, allDataFacts, store);
+    tdIFDSSolve(mainEntry, curEvalICFGNode, allDataFacts, curEvalFuns, store);
+
+    for (const auto &n: *getICFGWrapper()) {
+        const DataFactStore::DataFacts &tdFacts = store.getTdReachable(n.second);
+        const DataFactStore::DataFacts &buFacts = store.getBuReachable(n.second);
+        if (!tdFacts.empty() && !buFacts.empty()) {
+            for (const auto &df1: tdFacts) {
+                // has non-zero intersection datafacts
+                if (!df1.empty() && buFacts.count(df1)) {
+                    slice.push_back(n.first);
+                    break;
                 }
             }
         }
-        // N_t reaches snk
-        if (temporalSliceTmp.find(dataFact.front()) != temporalSliceTmp.end()) {
-            for (const auto &e: getICFGWrapper()->getICFGNodeWrapper(dataFact.front())->getOutEdges()) {
-                temporalSlice.insert(e->getDstID());
-            }
+    }
+}
+
+void TemporalSlicer::mergeSlice(const DataFact &dataFact, const std::vector<NodeID> &slice,
+                                NodeIDSet &temporalSlice) {
+    bool reachSnk = false;
+    for (const auto &id: slice) {
+        temporalSlice.insert(id);
+        if (id == dataFact.front()) reachSnk = true;
+    }
+    // N_t reaches snk
+    if (reachSnk) {
+        for (const auto &e: getICFGWrapper()->getICFGNodeWrapper(dataFact.front())->getOutEdges()) {
+            temporalSlice.insert(e->getDstID());
         }
     }
-    Log(LogLevel::Info) << SVFUtil::sucMsg("\nTemporal slicing...[done]\n");
-    Dump() << SVFUtil::sucMsg("\nTemporal slicing...[done]\n");
-    _temporalSlice = SVFUtil::move(temporalSlice);
 }
 
-void TemporalSlicer::initTDDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts) {
+void DataFactStore::commit() {
+    if (!_local) return;
+    for (auto &item: _tdTransferFuncs)
+        const_cast<ICFGEdgeWrapper *>(item.first)->_tdDataFactTransferFunc = SVFUtil::move(item.second);
+    for (auto &item: _buTransferFuncs)
+        const_cast<ICFGEdgeWrapper *>(item.first)->_buDataFactTransferFunc = SVFUtil::move(item.second);
+    for (auto &item: _tdReachables)
+        const_cast<ICFGNodeWrapper *>(item.first)->_tdReachableDataFacts = SVFUtil::move(item.second);
+    for (auto &item: _buReachables)
+        const_cast<ICFGNodeWrapper *>(item.first)->_buReachableDataFacts = SVFUtil::move(item.second);
+    _tdTransferFuncs.clear();
+    _buTransferFuncs.clear();
+    _tdReachables.clear();
+    _buReachables.clear();
+}
+
+void TemporalSlicer::initTDDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts,
+                                          DataFactStore &store) {
     for (const auto &item: *ICFGWrapper::getICFGWrapper(PAG::getPAG()->getICFG())) {
         if (item.second == mainEntry) {
             ICFGEdgeWrapper *edge = *item.second->getOutEdges().begin();
-            edge->_tdDataFactTransferFunc[DataFact()].insert(DataFact());
-            edge->_tdDataFactTransferFunc[DataFact()].insert(allDataFacts[0]);
+            store.tdTransferFunc(edge)[DataFact()].insert(DataFact());
+            store.tdTransferFunc(edge)[DataFact()].insert(allDataFacts[0]);
         } else {
-            if (item.second->_buReachableDataFacts.empty()) continue;
+            if (store.getBuReachable(item.second).empty()) continue;
             for (const auto &edge: item.second->getOutEdges()) {
                 for (const auto &dataFact: allDataFacts) {
                     if (dataFact.empty()) {
-                        edge->_tdDataFactTransferFunc[DataFact()].insert(DataFact());
+                        store.tdTransferFunc(edge)[DataFact()].insert(DataFact());
                     } else if (edge->getSrcID() == dataFact.back()) {
                         // edge: returnsite -> nxt or load -> nxt (UAF)
                         // the seq only contains return node
                         DataFact dstFact = dataFact;
                         dstFact.pop_back();
-                        if (item.second->_buReachableDataFacts.find(dataFact) !=
-                            item.second->_buReachableDataFacts.end())
-                            edge->_tdDataFactTransferFunc[dataFact].insert(SVFUtil::move(dstFact));
+                        if (store.getBuReachable(item.second).count(dataFact))
+                            store.tdTransferFunc(edge)[dataFact].insert(SVFUtil::move(dstFact));
                     } else {
-                        if (item.second->_buReachableDataFacts.find(dataFact) !=
-                            item.second->_buReachableDataFacts.end())
-                            edge->_tdDataFactTransferFunc[dataFact].insert(dataFact);
+                        if (store.getBuReachable(item.second).count(dataFact))
+                            store.tdTransferFunc(edge)[dataFact].insert(dataFact);
                     }
                 }
             }
@@ -113,25 +200,26 @@ void TemporalSlicer::initTDDFTransferFunc(const ICFGNodeWrapper *mainEntry, std:
     }
 }
 
-void TemporalSlicer::initBUDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts) {
+void TemporalSlicer::initBUDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts,
+                                          DataFactStore &store) {
     for (const auto &item: *ICFGWrapper::getICFGWrapper(PAG::getPAG()->getICFG())) {
         if (item.second == mainEntry) {
             ICFGEdgeWrapper *edge = *item.second->getOutEdges().begin();
-            edge->_buDataFactTransferFunc[DataFact()].insert(DataFact());
-            edge->_buDataFactTransferFunc[allDataFacts[0]].insert(DataFact());
+            store.buTransferFunc(edge)[DataFact()].insert(DataFact());
+            store.buTransferFunc(edge)[allDataFacts[0]].insert(DataFact());
         } else {
             for (const auto &edge: item.second->getOutEdges()) {
                 for (const auto &dataFact: allDataFacts) {
                     if (dataFact.empty()) {
-                        edge->_buDataFactTransferFunc[DataFact()].insert(DataFact());
+                        store.buTransferFunc(edge)[DataFact()].insert(DataFact());
                     } else if (edge->getSrcID() == dataFact.back()) {
                         // edge: returnsite -> nxt or load -> nxt (UAF)
                         // the seq only contains return node
                         DataFact dstFact = dataFact;
                         dstFact.pop_back();
-                        edge->_buDataFactTransferFunc[SVFUtil::move(dstFact)].insert(dataFact);
+                        store.buTransferFunc(edge)[SVFUtil::move(dstFact)].insert(dataFact);
                     } else {
-                        edge->_buDataFactTransferFunc[dataFact].insert(dataFact);
+                        store.buTransferFunc(edge)[dataFact].insert(dataFact);
                     }
                 }
             }
@@ -147,7 +235,8 @@ void TemporalSlicer::initBUDFTransferFunc(const ICFGNodeWrapper *mainEntry, std:
  * @param allDataFacts
  */
 void TemporalSlicer::tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNode *curEvalICFGNode,
-                                 std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns) {
+                                 std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns,
+                                 DataFactStore &store) {
     FIFOWorkList<TPSIFDSItem> workList;
     ICFG *icfg = PAG::getPAG()->getICFG();
     Map<const SVFFunction *, Map<DataFact, Set<DataFact>>> summaryMap;
@@ -161,8 +250,9 @@ void TemporalSlicer::tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
             for (const auto &edge: curItem.getDst().first->getOutEdges()) {
                 // add trigger
                 if (edge->getICFGEdge()->isCallCFGEdge()) {
-                    auto it2 = edge->_tdDataFactTransferFunc.find(curItem.getDst().second);
-                    if (it2 == edge->_tdDataFactTransferFunc.end()) continue;
+                    const DataFactStore::TransferFunc &transferFunc = store.tdTransferFunc(edge);
+                    auto it2 = transferFunc.find(curItem.getDst().second);
+                    if (it2 == transferFunc.end()) continue;
                     // for each <n, d2> --> <callee entry, d3>
                     for (const auto &dataFact: it2->second) {
                         TPSIFDSItem nxt(edge->getDstNode(), dataFact, edge->getDstNode(), dataFact);
@@ -171,8 +261,9 @@ void TemporalSlicer::tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 }
                 // callsite --> returnsite in E^#
                 if (edge->getDstNode() == curItem.getDst().first->getRetICFGNodeWrapper()) {
-                    auto it2 = edge->_tdDataFactTransferFunc.find(curItem.getDst().second);
-                    if (it2 == edge->_tdDataFactTransferFunc.end()) continue;
+                    const DataFactStore::TransferFunc &transferFunc = store.tdTransferFunc(edge);
+                    auto it2 = transferFunc.find(curItem.getDst().second);
+                    if (it2 == transferFunc.end()) continue;
                     for (const auto &dataFact: it2->second) {
                         TPSIFDSItem nxt(curItem.getSrc().first, curItem.getSrc().second, edge->getDstNode(),
                                         dataFact);
@@ -204,7 +295,7 @@ void TemporalSlicer::tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 Set<DataFact> d4s;
                 for (const auto &e: callsite->getOutEdges()) {
                     if (e->getICFGEdge()->isCallCFGEdge()) {
-                        for (const auto &item: e->_tdDataFactTransferFunc) {
+                        for (const auto &item: store.tdTransferFunc(e)) {
                             // item.first is d4
                             if (item.second.find(curItem.getSrc().second) != item.second.end()) {
                                 d4s.insert(item.first);
@@ -215,7 +306,7 @@ void TemporalSlicer::tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 Set<DataFact> d5s;
                 for (const auto &e: curItem.getDst().first->getOutEdges()) {
                     if (e->getICFGEdge()->isRetCFGEdge()) {
-                        auto it2 = e->_tdDataFactTransferFunc.find(curItem.getDst().second);
+                        auto it2 = store.tdTransferFunc(e).find(curItem.getDst().second);
                         d5s = it2->second;
                     }
                 }
@@ -241,8 +332,9 @@ void TemporalSlicer::tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 pathEdge.insert(TPSIFDSItem(curItem.getSrc().first, curItem.getSrc().second, retIcfgNode,
                                             curItem.getDst().second));
                 for (const auto &e: retIcfgNode->getOutEdges()) {
-                    auto it2 = e->_tdDataFactTransferFunc.find(curItem.getDst().second);
-                    if (it2 != e->_tdDataFactTransferFunc.end()) {
+                    const DataFactStore::TransferFunc &transferFunc = store.tdTransferFunc(e);
+                    auto it2 = transferFunc.find(curItem.getDst().second);
+                    if (it2 != transferFunc.end()) {
                         for (const auto &d3: it2->second) {
                             TPSIFDSItem nxt(curItem.getSrc().first, curItem.getSrc().second, e->getDstNode(), d3);
                             propagate(workList, pathEdge, nxt);
@@ -251,8 +343,9 @@ void TemporalSlicer::tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 }
             } else {
                 for (const auto &e: curItem.getDst().first->getOutEdges()) {
-                    auto it2 = e->_tdDataFactTransferFunc.find(curItem.getDst().second);
-                    if (it2 != e->_tdDataFactTransferFunc.end()) {
+                    const DataFactStore::TransferFunc &transferFunc = store.tdTransferFunc(e);
+                    auto it2 = transferFunc.find(curItem.getDst().second);
+                    if (it2 != transferFunc.end()) {
                         for (const auto &d3: it2->second) {
                             TPSIFDSItem nxt(curItem.getSrc().first, curItem.getSrc().second, e->getDstNode(), d3);
                             propagate(workList, pathEdge, nxt);
@@ -263,13 +356,14 @@ void TemporalSlicer::tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
         }
     }
     for (const auto &n: *getICFGWrapper()) {
+        if (!n.second->isMaterialized()) continue;
         for (const auto &d1: allDataFacts) {
             for (const auto &d2: allDataFacts) {
                 if (!d2.empty() && n.second->getICFGNode()->getFun()) {
                     TPSIFDSItem item(getICFGWrapper()->getFunEntry(n.second->getICFGNode()->getFun()), d1, n.second,
                                      d2);
                     if (pathEdge.find(item) != pathEdge.end()) {
-                        n.second->_tdReachableDataFacts.insert(d2);
+                        store.tdReachable(n.second).insert(d2);
                     }
                 }
             }
@@ -291,6 +385,8 @@ void TemporalSlicer::connectTowardsMainExit(const ICFGNodeWrapper *snkExit, Set<
         const ICFGNodeWrapper *curNode = workList.pop();
         if (const SVFFunction *fun = curNode->getICFGNode()->getFun()) {
             const ICFGNodeWrapper *funExit = getICFGWrapper()->getFunExit(fun);
+            // callers not reaching the snk are left as stubs
+            if (!funExit) continue;
             pathEdge.insert(TPSIFDSItem(funExit, DataFact(), curNode, DataFact()));
             for (const auto &outEdge: funExit->getOutEdges()) {
                 if (SVFUtil::isa<RetCFGEdge>(outEdge->getICFGEdge()) && !visited.count(outEdge->getDstNode())) {
@@ -308,7 +404,8 @@ void TemporalSlicer::connectTowardsMainExit(const ICFGNodeWrapper *snkExit, Set<
  * @param allDataFacts
  */
 void TemporalSlicer::buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNodeWrapper *snk, const ICFGNode *curEvalICFGNode,
-                                 std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns) {
+                                 std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns,
+                                 DataFactStore &store) {
     FIFOWorkList<TPSIFDSItem> workList;
     ICFG *icfg = PAG::getPAG()->getICFG();
     Map<const SVFFunction *, Map<DataFact, Set<DataFact>>> summaryMap;
@@ -326,7 +423,7 @@ void TemporalSlicer::buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
             for (const auto &edge: curItem.getDst().first->getInEdges()) {
                 // add trigger
                 if (edge->getICFGEdge()->isRetCFGEdge()) {
-                    auto it2 = edge->_buDataFactTransferFunc.find(curItem.getDst().second);
+                    auto it2 = store.buTransferFunc(edge).find(curItem.getDst().second);
                     // for each <n, d2> --> <callee entry, d3>
                     for (const auto &dataFact: it2->second) {
                         TPSIFDSItem nxt(edge->getSrcNode(), dataFact, edge->getSrcNode(), dataFact);
@@ -335,7 +432,7 @@ void TemporalSlicer::buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 }
                 // callsite --> returnsite in E^#
                 if (edge->getSrcNode() == curItem.getDst().first->getCallICFGNodeWrapper()) {
-                    auto it2 = edge->_buDataFactTransferFunc.find(curItem.getDst().second);
+                    auto it2 = store.buTransferFunc(edge).find(curItem.getDst().second);
                     for (const auto &dataFact: it2->second) {
                         TPSIFDSItem nxt(curItem.getSrc().first, curItem.getSrc().second, edge->getSrcNode(),
                                         dataFact);
@@ -367,7 +464,7 @@ void TemporalSlicer::buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 Set<DataFact> d4s;
                 for (const auto &e: retsite->getInEdges()) {
                     if (e->getICFGEdge()->isRetCFGEdge()) {
-                        for (const auto &item: e->_buDataFactTransferFunc) {
+                        for (const auto &item: store.buTransferFunc(e)) {
                             // item.first is d4
                             if (item.second.find(curItem.getSrc().second) != item.second.end()) {
                                 d4s.insert(item.first);
@@ -378,7 +475,7 @@ void TemporalSlicer::buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 Set<DataFact> d5s;
                 for (const auto &e: curItem.getDst().first->getInEdges()) {
                     if (e->getICFGEdge()->isCallCFGEdge()) {
-                        auto it2 = e->_buDataFactTransferFunc.find(curItem.getDst().second);
+                        auto it2 = store.buTransferFunc(e).find(curItem.getDst().second);
                         d5s = it2->second;
                     }
                 }
@@ -404,8 +501,9 @@ void TemporalSlicer::buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 pathEdge.insert(TPSIFDSItem(curItem.getSrc().first, curItem.getSrc().second, callIcfgNode,
                                             curItem.getDst().second));
                 for (const auto &e: callIcfgNode->getInEdges()) {
-                    auto it2 = e->_buDataFactTransferFunc.find(curItem.getDst().second);
-                    if (it2 != e->_buDataFactTransferFunc.end()) {
+                    const DataFactStore::TransferFunc &transferFunc = store.buTransferFunc(e);
+                    auto it2 = transferFunc.find(curItem.getDst().second);
+                    if (it2 != transferFunc.end()) {
                         for (const auto &d3: it2->second) {
                             TPSIFDSItem nxt(curItem.getSrc().first, curItem.getSrc().second, e->getSrcNode(), d3);
                             propagate(workList, pathEdge, nxt);
@@ -414,8 +512,9 @@ void TemporalSlicer::buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
                 }
             } else {
                 for (const auto &e: curItem.getDst().first->getInEdges()) {
-                    auto it2 = e->_buDataFactTransferFunc.find(curItem.getDst().second);
-                    if (it2 != e->_buDataFactTransferFunc.end()) {
+                    const DataFactStore::TransferFunc &transferFunc = store.buTransferFunc(e);
+                    auto it2 = transferFunc.find(curItem.getDst().second);
+                    if (it2 != transferFunc.end()) {
                         for (const auto &d3: it2->second) {
                             TPSIFDSItem nxt(curItem.getSrc().first, curItem.getSrc().second, e->getSrcNode(), d3);
                             propagate(workList, pathEdge, nxt);
@@ -426,12 +525,13 @@ void TemporalSlicer::buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNod
         }
     }
     for (const auto &n: *getICFGWrapper()) {
+        if (!n.second->isMaterialized()) continue;
         for (const auto &d1: allDataFacts) {
             for (const auto &d2: allDataFacts) {
                 if (!d2.empty() && n.second->getICFGNode()->getFun()) {
                     TPSIFDSItem item(getICFGWrapper()->getFunExit(n.second->getICFGNode()->getFun()), d1, n.second, d2);
                     if (pathEdge.find(item) != pathEdge.end()) {
-                        n.second->_buReachableDataFacts.insert(d2);
+                        store.buReachable(n.second).insert(d2);
                     }
                 }
             }
@@ -11,6 +11,71 @@
 
 namespace SVF {
 
+/*!
+ * Data facts of temporal slicing
+ *
+ * Transfer functions and reachable data facts live on the wrapper edges and nodes
+ * by default. A local store keeps them in its own maps instead, so that the PIs of
+ * a source can be solved on several threads (-tps-threads).
+ */
+class DataFactStore {
+public:
+    typedef PIState::DataFact DataFact;
+    typedef Set<DataFact> DataFacts;
+    typedef Map<DataFact, DataFacts> TransferFunc;
+
+private:
+    bool _local;
+    Map<const ICFGEdgeWrapper *, TransferFunc> _tdTransferFuncs;
+    Map<const ICFGEdgeWrapper *, TransferFunc> _buTransferFuncs;
+    Map<const ICFGNodeWrapper *, DataFacts> _tdReachables;
+    Map<const ICFGNodeWrapper *, DataFacts> _buReachables;
+
+    static inline const DataFacts &emptyDataFacts() {
+        static DataFacts empty;
+        return empty;
+    }
+
+public:
+    explicit DataFactStore(bool local = false) : _local(local) {}
+
+    /// Transfer functions of edge
+    //{%
+    inline TransferFunc &tdTransferFunc(ICFGEdgeWrapper *edge) {
+        return _local ? _tdTransferFuncs[edge] : edge->_tdDataFactTransferFunc;
+    }
+
+    inline TransferFunc &buTransferFunc(ICFGEdgeWrapper *edge) {
+        return _local ? _buTransferFuncs[edge] : edge->_buDataFactTransferFunc;
+    }
+    //%}
+
+    /// Reachable data facts of node
+    //{%
+    inline DataFacts &tdReachable(const ICFGNodeWrapper *node) {
+        return _local ? _tdReachables[node] : const_cast<ICFGNodeWrapper *>(node)->_tdReachableDataFacts;
+    }
+
+    inline DataFacts &buReachable(const ICFGNodeWrapper *node) {
+        return _local ? _buReachables[node] : const_cast<ICFGNodeWrapper *>(node)->_buReachableDataFacts;
+    }
+
+    inline const DataFacts &getTdReachable(const ICFGNodeWrapper *node) const {
+        if (!_local) return node->_tdReachableDataFacts;
+        auto it = _tdReachables.find(node);
+        return it == _tdReachables.end() ? emptyDataFacts() : it->second;
+    }
+
+    inline const DataFacts &getBuReachable(const ICFGNodeWrapper *node) const {
+        if (!_local) return node->_buReachableDataFacts;
+        auto it = _buReachables.find(node);
+        return it == _buReachables.end() ? emptyDataFacts() : it->second;
+    }
+    //%}
+
+    /// Move the local data facts onto the wrapper
+    void commit();
+}; // end class DataFactStore
 
 /*!
  * Temporal slicing
@@ -50,6 +115,14 @@ public:
     void
     temporalSlicing(const SVFGNode* src, const ICFGNodeWrapper *mainEntry);
 
+    /// Solve a PI bottom-up then top-down, collect the nodes reached by its non-zero data facts in both directions
+    static void
+    solvePI(const DataFact &dataFact, const ICFGNodeWrapper *mainEntry, const ICFGNode *curEvalICFGNode,
+            Set<const SVFFunction *> &curEvalFuns, DataFactStore &store, std::vector<NodeID> &slice);
+
+    /// Add the slice of a PI to temporalSlice
+    static void mergeSlice(const DataFact &dataFact, const std::vector<NodeID> &slice, NodeIDSet &temporalSlice);
+
     static inline void clearDF() {
         for (const auto &n: *getICFGWrapper()) {
             n.second->_tdReachableDataFacts.clear();
@@ -61,19 +134,48 @@ public:
         }
     }
 
-    static void initBUDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts);
+    static void initBUDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts,
+                                     DataFactStore &store);
 
-    static void initTDDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts);
+    static void initTDDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts,
+                                     DataFactStore &store);
 
     /// Top-Down IFDS solver for tailoring
     static void
     tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNode *curEvalICFGNode,
-                std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns);
+                std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns, DataFactStore &store);
 
     /// Bottom-Up IFDS solver for tailoring
     static void
     buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNodeWrapper *snk, const ICFGNode *curEvalICFGNode,
-                std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns);
+                std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns, DataFactStore &store);
+
+    /// Data facts on the wrapper
+    //{%
+    static inline void initBUDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts) {
+        DataFactStore store;
+        initBUDFTransferFunc(mainEntry, allDataFacts, store);
+    }
+
+    static inline void initTDDFTransferFunc(const ICFGNodeWrapper *mainEntry, std::vector<DataFact> &allDataFacts) {
+        DataFactStore store;
+        initTDDFTransferFunc(mainEntry, allDataFacts, store);
+    }
+
+    static inline void
+    tdIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNode *curEvalICFGNode,
+                std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns) {
+        DataFactStore store;
+        tdIFDSSolve(mainEntry, curEvalICFGNode, allDataFacts, curEvalFuns, store);
+    }
+
+    static inline void
+    buIFDSSolve(const ICFGNodeWrapper *mainEntry, const ICFGNodeWrapper *snk, const ICFGNode *curEvalICFGNode,
+                std::vector<DataFact> &allDataFacts, Set<const SVFFunction *> &curEvalFuns) {
+        DataFactStore store;
+        buIFDSSolve(mainEntry, snk, curEvalICFGNode, allDataFacts, curEvalFuns, store);
+    }
+    //%}
 
     static void connectTowardsMainExit(const ICFGNodeWrapper* snkExit, Set<TPSIFDSItem>& pathEdge);
 
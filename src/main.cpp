@@ -34,33 +34,19 @@
 #include "Detectors/UAFDetectorBase.h"
 #include "Detectors/DFDetectorBase.h"
 #include "PSTA/PSTABase.h"
+#include <fstream>
+#include <filesystem>
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
 
 using namespace SVF;
 
-int main(int argc, char **argv) {
-    // add arguments for svf
-    int arg_num = 0;
-    int extraArgc = 5;
-    char **arg_value = new char *[argc + extraArgc];
-    for (; arg_num < argc; ++arg_num) {
-        arg_value[arg_num] = argv[arg_num];
-    }
-    int orgArgNum = arg_num;
-    arg_value[arg_num++] = (char *) "-model-consts=true";
-    arg_value[arg_num++] = (char *) "-model-arrays=true";
-    arg_value[arg_num++] = (char *) "-pre-field-sensitive=false";
-    arg_value[arg_num++] = (char *) "-ff-eq-base";
-    arg_value[arg_num++] = (char *) "-field-limit=16";
-    assert(arg_num == (orgArgNum + extraArgc) && "more extra arguments? Change the value of extraArgc");
-
-    // build svf module
-    std::vector<std::string> moduleNameVec;
-    moduleNameVec = OptionBase::parseOptions(
-            arg_num, arg_value, "Path-sensitive Typestate Analysis", "[options] <input-bitcode...>"
-    );
-    SVFModule *svfModule = LLVMModuleSet::getLLVMModuleSet()->buildSVFModule(moduleNameVec);
+/*!
+ * Create the detector selected by the options
+ */
+static std::unique_ptr<PSTABase> createDetector() {
     std::unique_ptr<PSTABase> detector = nullptr;
-    // create detector
     if (PSAOptions::Base())
     {
         if (PSAOptions::LEAK()) {
@@ -72,8 +58,6 @@ int main(int argc, char **argv) {
         } else {
             assert(false && "invalid detector!");
         }
-        // start analysis
-        detector->runFSMOnModule(svfModule);
     } else {
         if (PSAOptions::LEAK()) {
             detector = std::make_unique<MemLeakDetector>();
@@ -84,11 +68,135 @@ int main(int argc, char **argv) {
         } else {
             assert(false && "invalid detector!");
         }
-        // start analysis
-        detector->runFSMOnModule(svfModule);
     }
+    return detector;
+}
+
+/*!
+ * Bitcode files listed in a manifest, one per line, '#' starts a comment line
+ * @return false if the manifest cannot be opened
+ */
+static bool readBatchList(const std::string &path, std::vector<std::string> &moduleNameVec) {
+    std::ifstream manifest(path);
+    if (!manifest.is_open())
+        return false;
+    std::string line;
+    while (std::getline(manifest, line)) {
+        line.erase(0, line.find_first_not_of(" \t\r"));
+        line.erase(line.find_last_not_of(" \t\r") + 1);
+        if (line.empty() || line[0] == '#') continue;
+        moduleNameVec.push_back(line);
+    }
+    return true;
+}
+
+/*!
+ * Analyze one module in a child process whose stdout and stderr go to reportPath
+ *
+ * Module state (PAG, SVFGs, ICFGWrapper, the dense id maps, LLVM's singletons) dies
+ * with the child, and a crash or failed assertion only loses this module
+ * @return empty if the module was analyzed, otherwise how the child ended
+ */
+static std::string analyzeModuleInChild(const std::string &moduleName, const std::string &reportPath) {
+    // nothing buffered in the parent may be printed again by the child
+    std::cout.flush();
+    SVFUtil::outs().flush();
+    SVFUtil::errs().flush();
+    pid_t pid = fork();
+    if (pid < 0)
+        return "fork failed";
+    if (pid == 0) {
+        int fd = open(reportPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0)
+            _exit(1);
+        // fd-level redirection also catches llvm::outs()/errs() and the Logger
+        dup2(fd, STDOUT_FILENO);
+        dup2(fd, STDERR_FILENO);
+        close(fd);
+        {
+            SVFModule *svfModule = LLVMModuleSet::getLLVMModuleSet()->buildSVFModule({moduleName});
+            std::unique_ptr<PSTABase> detector = createDetector();
+            detector->runFSMOnModule(svfModule);
+        }
+        std::exit(0);
+    }
+    int status = 0;
+    if (waitpid(pid, &status, 0) != pid)
+        return "lost the child process";
+    if (WIFEXITED(status) && WEXITSTATUS(status) == 0)
+        return "";
+    if (WIFSIGNALED(status))
+        return "killed by signal " + std::to_string(WTERMSIG(status));
+    return "exit code " + std::to_string(WEXITSTATUS(status));
+}
+
+/*!
+ * Analyze the modules one after another, each in its own child process
+ *
+ * Everything printed while analyzing the i-th module goes to <-o>/<i>_<module>.report,
+ * the index keeps modules with the same file name apart
+ * @return the number of modules whose analysis failed
+ */
+static u32_t runBatch(const std::vector<std::string> &moduleNameVec) {
+    std::filesystem::path outDir(PSAOptions::OUTPUT());
+    std::filesystem::create_directories(outDir);
+    u32_t ct = 0, failures = 0;
+    for (const auto &moduleName: moduleNameVec) {
+        ++ct;
+        std::string reportName =
+                std::to_string(ct) + "_" + std::filesystem::path(moduleName).stem().string() + ".report";
+        std::string reportPath = (outDir / reportName).string();
+        std::string failure = analyzeModuleInChild(moduleName, reportPath);
+        SVFUtil::outs() << "[" << ct << "/" << moduleNameVec.size() << "] " << moduleName << " --> " << reportPath;
+        if (!failure.empty()) {
+            ++failures;
+            SVFUtil::outs() << " FAILED (" << failure << ")";
+        }
+        SVFUtil::outs() << "\n";
+    }
+    if (failures)
+        SVFUtil::errs() << SVFUtil::errMsg("batch: ") << failures << " of " << moduleNameVec.size()
+                        << " modules failed\n";
+    return failures;
+}
+
+int main(int argc, char **argv) {
+    // add arguments for svf
+    int arg_num = 0;
+    int extraArgc = 5;
+    char **arg_value = new char *[argc + extraArgc];
+    for (; arg_num < argc; ++arg_num) {
+        arg_value[arg_num] = argv[arg_num];
+    }
+    int orgArgNum = arg_num;
+    arg_value[arg_num++] = (char *) "-model-consts=true";
+    arg_value[arg_num++] = (char *) "-model-arrays=true";
+    arg_value[arg_num++] = (char *) "-pre-field-sensitive=false";
+    arg_value[arg_num++] = (char *) "-ff-eq-base";
+    arg_value[arg_num++] = (char *) "-field-limit=16";
+    assert(arg_num == (orgArgNum + extraArgc) && "more extra arguments? Change the value of extraArgc");
+
+    // build svf module
+    std::vector<std::string> moduleNameVec;
+    moduleNameVec = OptionBase::parseOptions(
+            arg_num, arg_value, "Path-sensitive Typestate Analysis", "[options] <input-bitcode...>"
+    );
+    if (!PSAOptions::BatchList().empty() && !readBatchList(PSAOptions::BatchList(), moduleNameVec)) {
+        SVFUtil::errs() << SVFUtil::errMsg("cannot open batch list: ") << PSAOptions::BatchList() << "\n";
+        delete[] arg_value;
+        return 1;
+    }
+    if (PSAOptions::Batch() || !PSAOptions::BatchList().empty()) {
+        u32_t failures = runBatch(moduleNameVec);
+        delete[] arg_value;
+        return failures ? 1 : 0;
+    }
+    SVFModule *svfModule = LLVMModuleSet::getLLVMModuleSet()->buildSVFModule(moduleNameVec);
+    // create detector
+    std::unique_ptr<PSTABase> detector = createDetector();
+    // start analysis
+    detector->runFSMOnModule(svfModule);
 
     delete[] arg_value;
     return 0;
 }
-